@@ -140,6 +140,9 @@ typedef std::multimap<std::string, std::string>                Params;
 typedef std::smatch                                            Match;
 typedef std::function<bool (uint64_t current, uint64_t total)> Progress;
 
+struct Response;
+typedef std::function<bool (const Response &res, const char *data, size_t data_length)> ContentReceiver;
+
 struct MultipartFile {
     std::string filename;
     std::string content_type;
@@ -161,6 +164,10 @@ struct Request {
 
     Progress       progress;
 
+    // When set, the response body is handed to this as it arrives instead of
+    // being stored in Response::body
+    ContentReceiver content_receiver;
+
     bool has_header(const std::string &key) const;
     std::string get_header_value(const std::string &key) const;
     void set_header(const std::string &key, const std::string &val);
@@ -322,6 +329,7 @@ public:
 
     std::shared_ptr<Response> Post(const std::string &path, const std::string& body, const std::string& content_type);
     std::shared_ptr<Response> Post(const std::string &path, const Headers& headers, const std::string& body, const std::string &content_type);
+    std::shared_ptr<Response> Post(const std::string &path, const Headers& headers, const std::string& body, const std::string &content_type, ContentReceiver content_receiver);
 
     std::shared_ptr<Response> Post(const std::string &path, const Params& params);
     std::shared_ptr<Response> Post(const std::string &path, const Headers& headers, const Params& params);
@@ -1038,6 +1046,8 @@ inline bool read_headers(Stream& strm, Headers& headers)
     return true;
 }
 
+typedef std::function<bool (const char *data, size_t data_length)> ChunkReceiver;
+
 inline bool read_content_with_length(Stream& strm, std::string& out, size_t len, Progress progress)
 {
     out.assign(len, 0);
@@ -1076,7 +1086,7 @@ inline bool read_content_without_length(Stream& strm, std::string& out)
     return true;
 }
 
-inline bool read_content_chunked(Stream& strm, std::string& out)
+inline bool read_content_chunked(Stream& strm, std::string& out, ChunkReceiver receiver = nullptr)
 {
     const auto bufsiz = 16;
     char buf[bufsiz];
@@ -1103,7 +1113,13 @@ inline bool read_content_chunked(Stream& strm, std::string& out)
             break;
         }
 
-        out += chunk;
+        if (receiver) {
+            if (!receiver(chunk.data(), chunk.size())) {
+                return false;
+            }
+        } else {
+            out += chunk;
+        }
 
         if (!reader.getline()) {
             return false;
@@ -1122,7 +1138,7 @@ inline bool read_content_chunked(Stream& strm, std::string& out)
 }
 
 template <typename T>
-bool read_content(Stream& strm, T& x, Progress progress = Progress())
+bool read_content(Stream& strm, T& x, Progress progress = Progress(), ChunkReceiver receiver = nullptr)
 {
     uint64_t bodyLen = 0;
 
@@ -1137,8 +1153,18 @@ bool read_content(Stream& strm, T& x, Progress progress = Progress())
 
         if (!strcasecmp(encoding, "chunked"))
         {
-            return read_content_chunked(strm, x.body);
+            return read_content_chunked(strm, x.body, receiver);
+        }
+    }
+
+    if (receiver) {
+        std::string body;
+
+        if (!read_content_with_length(strm, body, bodyLen, progress)) {
+            return false;
         }
+
+        return body.empty() || receiver(body.data(), body.size());
     }
 
     return read_content_with_length(strm, x.body, bodyLen, progress);
@@ -2473,6 +2499,13 @@ inline bool Client::send(Request& req, Response& res, const bool isRetry)
        the socket so we make a new one on next request.*/
     opened_connection_ = INVALID_SOCKET;
 
+    /* The receiver may have already been handed part of the body, retrying
+       would hand it the same data again */
+    if (req.content_receiver && res.status != -1)
+    {
+        return false;
+    }
+
     /* If the request failed, it's possible the socket timed out,
        let's give it one more try to make sure */
     if (!isRetry)
@@ -2557,7 +2590,15 @@ inline bool Client::process_request(Stream& strm, Request& req, Response& res, b
 
     // Body
     if (req.method != "HEAD") {
-        if (!detail::read_content(strm, res, req.progress)) {
+        detail::ChunkReceiver receiver = nullptr;
+
+        if (req.content_receiver) {
+            receiver = [&](const char *data, size_t data_length) {
+                return req.content_receiver(res, data, data_length);
+            };
+        }
+
+        if (!detail::read_content(strm, res, req.progress, receiver)) {
             return false;
         }
         if (res.get_header_value("Content-Encoding") == "gzip") {
@@ -2651,6 +2692,24 @@ inline std::shared_ptr<Response> Client::Post(
     return send(req, *res) ? res : nullptr;
 }
 
+inline std::shared_ptr<Response> Client::Post(
+    const std::string &path, const Headers& headers, const std::string& body, const std::string &content_type,
+    ContentReceiver content_receiver)
+{
+    Request req;
+    req.method = "POST";
+    req.headers = headers;
+    req.path = path;
+    req.content_receiver = content_receiver;
+
+    req.headers.emplace("Content-Type", content_type);
+    req.body = body;
+
+    auto res = std::make_shared<Response>();
+
+    return send(req, *res) ? res : nullptr;
+}
+
 inline std::shared_ptr<Response> Client::Post(const std::string &path, const Params& params)
 {
     return Post(path, Headers(), params);
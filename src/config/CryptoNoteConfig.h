@@ -257,6 +257,10 @@ namespace CryptoNote
 
   const size_t   BLOCKS_IDS_SYNCHRONIZING_DEFAULT_COUNT                    = 10000;           // by default, blocks ids count in synchronizing
   const uint64_t BLOCKS_SYNCHRONIZING_DEFAULT_COUNT                        = 20;              // by default, blocks count in blocks downloading
+  const uint64_t WALLET_SYNC_STREAM_BATCH_SIZE                             = 5;               // blocks read per write when streaming binary wallet sync data
+  const size_t   WALLET_SYNC_CACHE_MAX_SIZE                                = 64 * 1024 * 1024; // max bytes of encoded wallet sync blocks to cache
+  const uint64_t WALLET_SYNC_STREAM_MAX_BLOCK_SIZE                         = 4 * 1024 * 1024; // max decompressed bytes of binary wallet sync data a wallet accepts per block asked for
+  const uint32_t IMPORT_BLOCKS_BATCH_SIZE                                  = 100;             // blocks prepared and committed at once when importing from blockchain storage
   const size_t   COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT                     = 100;
   const int      P2P_DEFAULT_PORT                                          = 20118;           // P2P Port
   const int      RPC_DEFAULT_PORT                                          = 20221;           // RPC Port
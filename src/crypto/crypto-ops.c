@@ -1811,6 +1811,50 @@ void ge_tobytes(unsigned char *s, const ge_p2 *h)
     s[31] ^= fe_isnegative(x) << 7;
 }
 
+/* Same as ge_tobytes on each of the count points, but shares a single field
+   inversion between all of them (Montgomery's trick). scratch must have room
+   for count elements. Every Z coordinate must be non zero, which holds for
+   any point produced by the ge_* functions. */
+void ge_tobytes_batch(unsigned char *s, const ge_p2 *h, fe *scratch, size_t count)
+{
+    fe inv;
+    fe recip;
+    fe x;
+    fe y;
+    size_t i;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    /* scratch[i] = Z_0 * Z_1 * ... * Z_i */
+    fe_copy(scratch[0], h[0].Z);
+    for (i = 1; i < count; i++)
+    {
+        fe_mul(scratch[i], scratch[i - 1], h[i].Z);
+    }
+
+    fe_invert(inv, scratch[count - 1]);
+
+    for (i = count - 1; i > 0; i--)
+    {
+        /* inv is (Z_0 * ... * Z_i)^-1 here */
+        fe_mul(recip, inv, scratch[i - 1]);
+        fe_mul(inv, inv, h[i].Z);
+
+        fe_mul(x, h[i].X, recip);
+        fe_mul(y, h[i].Y, recip);
+        fe_tobytes(s + 32 * i, y);
+        s[32 * i + 31] ^= fe_isnegative(x) << 7;
+    }
+
+    fe_mul(x, h[0].X, inv);
+    fe_mul(y, h[0].Y, inv);
+    fe_tobytes(s, y);
+    s[31] ^= fe_isnegative(x) << 7;
+}
+
 /* From sc_reduce.c */
 
 /*
@@ -2236,13 +2280,9 @@ static void ge_cached_cmov(ge_cached *t, const ge_cached *u, unsigned char b)
 }
 
 /* Assumes that a[31] <= 127 */
-void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A)
+void sc_recode_radix16(signed char *e, const unsigned char *a)
 {
-    signed char e[64];
     int carry, carry2, i;
-    ge_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
-    ge_p1p1 t;
-    ge_p3 u;
 
     carry = 0; /* 0..1 */
     for (i = 0; i < 31; i++)
@@ -2257,6 +2297,25 @@ void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A)
     carry2 = (carry + 8) >> 4; /* 0..8 */
     e[62] = carry - (carry2 << 4); /* -8..7 */
     e[63] = carry2; /* 0..8 */
+}
+
+/* Assumes that a[31] <= 127 */
+void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A)
+{
+    signed char e[64];
+
+    sc_recode_radix16(e, a);
+    ge_scalarmult_recoded(r, e, A);
+}
+
+/* e is the output of sc_recode_radix16, so a caller multiplying many points
+   by the same scalar only has to recode it once */
+void ge_scalarmult_recoded(ge_p2 *r, const signed char *e, const ge_p3 *A)
+{
+    int i;
+    ge_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
+    ge_p1p1 t;
+    ge_p3 u;
 
     ge_p3_to_cached(&Ai[0], A);
     for (i = 0; i < 7; i++)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* From fe.h */
@@ -108,6 +109,8 @@ void ge_sub(ge_p1p1 *, const ge_p3 *, const ge_cached *);
 
 void ge_tobytes(unsigned char *, const ge_p2 *);
 
+void ge_tobytes_batch(unsigned char *, const ge_p2 *, fe *, size_t);
+
 /* From sc_reduce.c */
 
 void sc_reduce(unsigned char *);
@@ -116,6 +119,10 @@ void sc_reduce(unsigned char *);
 
 void ge_scalarmult(ge_p2 *, const unsigned char *, const ge_p3 *);
 
+void sc_recode_radix16(signed char *, const unsigned char *);
+
+void ge_scalarmult_recoded(ge_p2 *, const signed char *, const ge_p3 *);
+
 void ge_double_scalarmult_precomp_vartime(
     ge_p2 *,
     const unsigned char *,
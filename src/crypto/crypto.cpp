@@ -312,6 +312,117 @@ namespace Crypto
         return true;
     }
 
+    std::vector<KeyDerivation>
+        crypto_ops::generate_key_derivations(const std::vector<PublicKey> &publicKeys, const SecretKey &secretKey)
+    {
+        assert(sc_check(reinterpret_cast<const unsigned char *>(&secretKey)) == 0);
+
+        KeyDerivation zero;
+        std::fill(std::begin(zero.data), std::end(zero.data), 0);
+
+        /* Invalid keys are left as a zeroed derivation */
+        std::vector<KeyDerivation> derivations(publicKeys.size(), zero);
+
+        /* The secret key is the same for every multiplication, so only
+           recode it once */
+        signed char recodedKey[64];
+        sc_recode_radix16(recodedKey, reinterpret_cast<const unsigned char *>(&secretKey));
+
+        std::vector<ge_p2> points;
+        points.reserve(publicKeys.size());
+
+        /* Index of the derivation each point belongs to, since invalid keys
+           are skipped */
+        std::vector<size_t> indexes;
+        indexes.reserve(publicKeys.size());
+
+        for (size_t i = 0; i < publicKeys.size(); i++)
+        {
+            ge_p3 point;
+            ge_p2 point2;
+            ge_p1p1 point3;
+
+            if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&publicKeys[i])) != 0)
+            {
+                continue;
+            }
+
+            ge_scalarmult_recoded(&point2, recodedKey, &point);
+            ge_mul8(&point3, &point2);
+            ge_p1p1_to_p2(&point2, &point3);
+
+            points.push_back(point2);
+            indexes.push_back(i);
+        }
+
+        std::unique_ptr<fe[]> scratch(new fe[points.size()]);
+        std::vector<unsigned char> compressed(points.size() * 32);
+
+        ge_tobytes_batch(compressed.data(), points.data(), scratch.get(), points.size());
+
+        for (size_t i = 0; i < indexes.size(); i++)
+        {
+            std::memcpy(&derivations[indexes[i]], compressed.data() + i * 32, 32);
+        }
+
+        return derivations;
+    }
+
+    std::vector<PublicKey> crypto_ops::underive_public_keys(
+        const std::vector<KeyDerivation> &derivations,
+        const std::vector<OutputToUnderive> &outputs)
+    {
+        PublicKey zero;
+        std::fill(std::begin(zero.data), std::end(zero.data), 0);
+
+        /* Invalid keys are left as a zeroed public key */
+        std::vector<PublicKey> bases(outputs.size(), zero);
+
+        std::vector<ge_p2> points;
+        points.reserve(outputs.size());
+
+        std::vector<size_t> indexes;
+        indexes.reserve(outputs.size());
+
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            const auto &output = outputs[i];
+
+            EllipticCurveScalar scalar;
+            ge_p3 point1;
+            ge_p3 point2;
+            ge_cached point3;
+            ge_p1p1 point4;
+            ge_p2 point5;
+
+            if (ge_frombytes_vartime(&point1, reinterpret_cast<const unsigned char *>(&output.outputKey)) != 0)
+            {
+                continue;
+            }
+
+            derivation_to_scalar(derivations[output.derivationIndex], output.outputIndex, scalar);
+            ge_scalarmult_base(&point2, reinterpret_cast<unsigned char *>(&scalar));
+            ge_p3_to_cached(&point3, &point2);
+            ge_sub(&point4, &point1, &point3);
+            ge_p1p1_to_p2(&point5, &point4);
+
+            points.push_back(point5);
+            indexes.push_back(i);
+        }
+
+        std::unique_ptr<fe[]> scratch(new fe[points.size()]);
+        std::vector<unsigned char> compressed(points.size() * 32);
+
+        ge_tobytes_batch(compressed.data(), points.data(), scratch.get(), points.size());
+
+        for (size_t i = 0; i < indexes.size(); i++)
+        {
+            std::memcpy(&bases[indexes[i]], compressed.data() + i * 32, 32);
+        }
+
+        return bases;
+    }
+
     struct s_comm
     {
         Hash h;
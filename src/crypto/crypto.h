@@ -28,6 +28,19 @@ namespace Crypto
         uint8_t data[32];
     };
 
+    /* A single output to scan with underive_public_keys() */
+    struct OutputToUnderive
+    {
+        /* Index into the derivations passed alongside the outputs */
+        size_t derivationIndex;
+
+        /* The index of the output in its transaction */
+        size_t outputIndex;
+
+        /* The one time key of the output */
+        PublicKey outputKey;
+    };
+
     class crypto_ops
     {
         crypto_ops();
@@ -160,6 +173,13 @@ namespace Crypto
             const std::vector<PublicKey> pubs,
             const std::vector<Signature> signatures);
 
+        static std::vector<KeyDerivation>
+            generate_key_derivations(const std::vector<PublicKey> &publicKeys, const SecretKey &secretKey);
+
+        static std::vector<PublicKey> underive_public_keys(
+            const std::vector<KeyDerivation> &derivations,
+            const std::vector<OutputToUnderive> &outputs);
+
         static void generateViewFromSpend(const Crypto::SecretKey &spend, Crypto::SecretKey &viewSecret);
 
         static void generateViewFromSpend(
@@ -247,6 +267,18 @@ namespace Crypto
         return crypto_ops::generate_key_derivation(key1, key2, derivation);
     }
 
+    /* Batched version of generate_key_derivation, for scanning many
+     * transactions with the same view key. The secret key is only recoded
+     * once, and the point compression of every derivation shares a single
+     * field inversion. Keys which are not valid points give a zeroed
+     * derivation.
+     */
+    inline std::vector<KeyDerivation>
+        generate_key_derivations(const std::vector<PublicKey> &publicKeys, const SecretKey &secretKey)
+    {
+        return crypto_ops::generate_key_derivations(publicKeys, secretKey);
+    }
+
     inline bool derive_public_key(
         const KeyDerivation &derivation,
         size_t output_index,
@@ -322,6 +354,17 @@ namespace Crypto
         return crypto_ops::underive_public_key(derivation, output_index, derived_key, base);
     }
 
+    /* Batched version of underive_public_key. Returns the base (spend) key
+     * of every output, in the same order as the outputs are given. Outputs
+     * with an invalid key give a zeroed public key.
+     */
+    inline std::vector<PublicKey> underive_public_keys(
+        const std::vector<KeyDerivation> &derivations,
+        const std::vector<OutputToUnderive> &outputs)
+    {
+        return crypto_ops::underive_public_keys(derivations, outputs);
+    }
+
     /* Generation and checking of a standard signature.
      */
     inline void generate_signature(const Hash &prefix_hash, const PublicKey &pub, const SecretKey &sec, Signature &sig)
@@ -0,0 +1,128 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <algorithm>
+#include <cryptonotecore/BlockSignatureVerifier.h>
+#include <cryptonotecore/ValidateTransaction.h>
+#include <utility>
+
+BlockSignatureVerifier::BlockSignatureVerifier(Utilities::WorkStealingThreadPool &threadPool) :
+    m_threadPool(threadPool)
+{
+}
+
+void BlockSignatureVerifier::addTransaction(ValidateTransaction &transaction)
+{
+    const uint32_t transactionIndex = static_cast<uint32_t>(m_transactions.size());
+
+    m_transactions.push_back({&transaction, transaction.m_cachedTransaction.getTransactionPrefixHash()});
+
+    /* Transactions in a checkpoints range are assumed valid */
+    if (!transaction.requiresExpensiveChecks())
+    {
+        return;
+    }
+
+    const uint32_t inputCount = static_cast<uint32_t>(transaction.m_transaction.inputs.size());
+
+    for (uint32_t inputIndex = 0; inputIndex < inputCount; inputIndex++)
+    {
+        m_inputs.push_back({transactionIndex, inputIndex});
+    }
+}
+
+std::optional<size_t> BlockSignatureVerifier::verify()
+{
+    if (m_inputs.empty())
+    {
+        return std::nullopt;
+    }
+
+    m_nextInput = 0;
+    m_firstFailure = NO_FAILURE;
+    m_threw = false;
+    m_exception = nullptr;
+
+    /* This thread checks inputs too, so with a single input there is no
+     * point waking anyone else up */
+    const size_t runnerCount = std::min<size_t>(m_threadPool.threadCount(), m_inputs.size() - 1);
+
+    Utilities::WaitGroup runners;
+
+    m_threadPool.submitBulk(runners, runnerCount, [this] {
+        processInputs();
+    });
+
+    processInputs();
+
+    /* The runners reference us, so wait for them even if we already know
+     * the result. Any which start late will find nothing left to claim. */
+    m_threadPool.wait(runners);
+
+    if (m_exception)
+    {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+
+    const size_t firstFailure = m_firstFailure;
+
+    if (firstFailure == NO_FAILURE)
+    {
+        return std::nullopt;
+    }
+
+    return m_inputs[firstFailure].transactionIndex;
+}
+
+void BlockSignatureVerifier::processInputs()
+{
+    /* Reused between inputs, so checking an input doesn't allocate once
+     * these have grown to the largest ring size */
+    std::vector<uint32_t> globalIndexes;
+    std::vector<Crypto::PublicKey> outputKeys;
+
+    /* Inputs are claimed in order, so every input before a failed one has
+     * already been claimed and will be finished - this makes the reported
+     * failure the same no matter how the threads are scheduled */
+    while (m_firstFailure == NO_FAILURE && !m_threw)
+    {
+        const size_t index = m_nextInput.fetch_add(1);
+
+        if (index >= m_inputs.size())
+        {
+            return;
+        }
+
+        const Input &input = m_inputs[index];
+        const Transaction &transaction = m_transactions[input.transactionIndex];
+
+        try
+        {
+            if (transaction.validator->validateTransactionInputExpensive(
+                    input.inputIndex, transaction.prefixHash, globalIndexes, outputKeys))
+            {
+                continue;
+            }
+        }
+        catch (...)
+        {
+            std::scoped_lock<std::mutex> lock(m_exceptionMutex);
+
+            if (!m_exception)
+            {
+                m_exception = std::current_exception();
+            }
+
+            m_threw = true;
+
+            return;
+        }
+
+        size_t firstFailure = m_firstFailure;
+
+        while (index < firstFailure && !m_firstFailure.compare_exchange_weak(firstFailure, index))
+        {
+        }
+    }
+}
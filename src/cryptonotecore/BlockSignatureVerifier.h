@@ -0,0 +1,98 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoTypes.h>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <utilities/WorkStealingThreadPool.h>
+#include <vector>
+
+class ValidateTransaction;
+
+/* Performs the expensive input checks (key image not spent, output keys
+ * exist and are unlocked, ring signatures are valid) of a set of
+ * transactions as a single batch, so a block with many small transactions,
+ * or a few huge fusion transactions, keeps every thread in the pool busy.
+ *
+ * Rather than a job per input, one runner per thread is submitted, and each
+ * runner claims the next unchecked input until none remain. Verification
+ * stops as soon as any input fails. */
+class BlockSignatureVerifier
+{
+    public:
+        /////////////////
+        /* CONSTRUCTOR */
+        /////////////////
+        BlockSignatureVerifier(Utilities::WorkStealingThreadPool &threadPool);
+
+        /////////////////////////////
+        /* PUBLIC MEMBER FUNCTIONS */
+        /////////////////////////////
+
+        /* Queues every input of the transaction. The validator must stay
+         * alive until verify() returns. */
+        void addTransaction(ValidateTransaction &transaction);
+
+        /* Checks every queued input. Returns the index (in the order they were
+         * added) of the first transaction with an invalid input, whose
+         * validation result holds the reason, or nothing if all are valid.
+         * If checking an input throws, such as on a database read error, the
+         * exception is rethrown here once every runner has finished. */
+        std::optional<size_t> verify();
+
+    private:
+        //////////////////////////////
+        /* PRIVATE MEMBER FUNCTIONS */
+        //////////////////////////////
+
+        /* Checks inputs until they have all been claimed, or one fails or
+         * throws. Never throws itself, as the pool's jobs mustn't. */
+        void processInputs();
+
+        /////////////////////////
+        /* PRIVATE MEMBER VARS */
+        /////////////////////////
+        struct Transaction
+        {
+            ValidateTransaction *validator;
+
+            /* Computed up front, the cached transaction lazily fills it in
+             * and isn't safe to share between threads until it has */
+            Crypto::Hash prefixHash;
+        };
+
+        struct Input
+        {
+            uint32_t transactionIndex;
+
+            uint32_t inputIndex;
+        };
+
+        static constexpr size_t NO_FAILURE = std::numeric_limits<size_t>::max();
+
+        std::vector<Transaction> m_transactions;
+
+        std::vector<Input> m_inputs;
+
+        /* Index of the next input for a runner to claim */
+        std::atomic<size_t> m_nextInput = 0;
+
+        /* Lowest index of the inputs which have failed */
+        std::atomic<size_t> m_firstFailure = NO_FAILURE;
+
+        /* Set once checking an input has thrown, so the runners stop */
+        std::atomic<bool> m_threw = false;
+
+        /* The first exception thrown checking an input */
+        std::exception_ptr m_exception;
+
+        std::mutex m_exceptionMutex;
+
+        Utilities::WorkStealingThreadPool &m_threadPool;
+};
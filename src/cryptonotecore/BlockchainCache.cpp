@@ -992,6 +992,12 @@ namespace CryptoNote
         serialize(s);
     }
 
+    void BlockchainCache::beginWriteBatch() {}
+
+    void BlockchainCache::commitWriteBatch() {}
+
+    void BlockchainCache::discardWriteBatch() {}
+
     bool BlockchainCache::isTransactionSpendTimeUnlocked(uint64_t unlockTime) const
     {
         return isTransactionSpendTimeUnlocked(unlockTime, getTopBlockIndex());
@@ -1030,6 +1036,56 @@ namespace CryptoNote
     }
 
     std::vector<uint32_t> BlockchainCache::getRandomOutsByAmount(Amount amount, size_t count, uint32_t blockIndex) const
+    {
+        std::vector<uint32_t> outputs = getSegmentRandomOutsByAmount(amount, count, blockIndex);
+
+        /* Didn't get enough outputs. Try parent. */
+        if (outputs.size() < count && parent != nullptr)
+        {
+            const auto prevs = parent->getRandomOutsByAmount(amount, count - outputs.size(), blockIndex);
+
+            std::copy(prevs.begin(), prevs.end(), std::back_inserter(outputs));
+        }
+
+        return outputs;
+    }
+
+    void BlockchainCache::getRandomKeyOutputsByAmount(
+        uint64_t amount,
+        size_t count,
+        uint32_t blockIndex,
+        std::vector<uint32_t> &globalIndexes,
+        std::vector<Crypto::PublicKey> &publicKeys) const
+    {
+        std::vector<uint32_t> outputs = getSegmentRandomOutsByAmount(amount, count, blockIndex);
+
+        /* The parent's outputs all come before ours, so fetch them first to
+           keep the results sorted */
+        if (outputs.size() < count && parent != nullptr)
+        {
+            parent->getRandomKeyOutputsByAmount(amount, count - outputs.size(), blockIndex, globalIndexes, publicKeys);
+        }
+
+        if (outputs.empty())
+        {
+            return;
+        }
+
+        std::sort(outputs.begin(), outputs.end());
+
+        const auto result = extractKeyOutputKeys(amount, blockIndex, {outputs.data(), outputs.size()}, publicKeys);
+
+        if (result != ExtractOutputKeysResult::SUCCESS)
+        {
+            logger(Logging::DEBUGGING) << "getRandomKeyOutputsByAmount: failed to extract key outputs";
+            throw std::runtime_error("Failed to extract key outputs");
+        }
+
+        globalIndexes.insert(globalIndexes.end(), outputs.begin(), outputs.end());
+    }
+
+    std::vector<uint32_t>
+        BlockchainCache::getSegmentRandomOutsByAmount(Amount amount, size_t count, uint32_t blockIndex) const
     {
         std::vector<uint32_t> outputs;
 
@@ -1038,16 +1094,7 @@ namespace CryptoNote
         /* No outputs found for this amount */
         if (it == keyOutputsGlobalIndexes.end())
         {
-            /* Try the parent if it exists */
-            if (parent != nullptr)
-            {
-                return parent->getRandomOutsByAmount(amount, count, blockIndex);
-            }
-            /* Failed to get outputs */
-            else
-            {
-                return outputs;
-            }
+            return outputs;
         }
 
         const std::vector<PackedOutIndex> &outs = it->second.outputs;
@@ -1083,14 +1130,6 @@ namespace CryptoNote
             }
         }
 
-        /* Didn't get enough outputs. Try parent. */
-        if (outputs.size() < count && parent != nullptr)
-        {
-            const auto prevs = parent->getRandomOutsByAmount(amount, count - outputs.size(), blockIndex);
-
-            std::copy(prevs.begin(), prevs.end(), std::back_inserter(outputs));
-        }
-
         return outputs;
     }
 
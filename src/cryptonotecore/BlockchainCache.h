@@ -227,6 +227,12 @@ namespace CryptoNote
 
         virtual void load() override;
 
+        virtual void beginWriteBatch() override;
+
+        virtual void commitWriteBatch() override;
+
+        virtual void discardWriteBatch() override;
+
         virtual std::vector<BinaryArray> getRawTransactions(
             const std::vector<Crypto::Hash> &transactions,
             std::vector<Crypto::Hash> &missedTransactions) const override;
@@ -251,6 +257,13 @@ namespace CryptoNote
         virtual std::vector<uint32_t>
             getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const override;
 
+        virtual void getRandomKeyOutputsByAmount(
+            uint64_t amount,
+            size_t count,
+            uint32_t blockIndex,
+            std::vector<uint32_t> &globalIndexes,
+            std::vector<Crypto::PublicKey> &publicKeys) const override;
+
         virtual ExtractOutputKeysResult extractKeyOutputs(
             uint64_t amount,
             uint32_t blockIndex,
@@ -399,6 +412,10 @@ namespace CryptoNote
 
         uint32_t insertKeyOutputToGlobalIndex(uint64_t amount, PackedOutIndex output, uint32_t blockIndex);
 
+        /* Picks up to count random unlocked outputs of the amount from this
+           segment only */
+        std::vector<uint32_t> getSegmentRandomOutsByAmount(Amount amount, size_t count, uint32_t blockIndex) const;
+
         enum class OutputSearchResult : uint8_t
         {
             FOUND,
@@ -13,6 +13,7 @@
 #include <common/ShuffleGenerator.h>
 #include <common/TransactionExtra.h>
 #include <config/Constants.h>
+#include <cryptonotecore/BlockSignatureVerifier.h>
 #include <cryptonotecore/BlockchainCache.h>
 #include <cryptonotecore/BlockchainStorage.h>
 #include <cryptonotecore/BlockchainUtils.h>
@@ -25,10 +26,13 @@
 #include <cryptonotecore/TransactionApi.h>
 #include <cryptonotecore/TransactionPool.h>
 #include <cryptonotecore/TransactionPoolCleaner.h>
+#include <cryptonotecore/TransactionValidationErrors.h>
 #include <cryptonotecore/UpgradeManager.h>
 #include <cryptonotecore/ValidateTransaction.h>
 #include <cryptonoteprotocol/CryptoNoteProtocolHandlerCommon.h>
+#include <deque>
 #include <numeric>
+#include <serialization/WalletSyncStream.h>
 #include <set>
 #include <system/Timer.h>
 #include <unordered_set>
@@ -228,6 +232,53 @@ namespace CryptoNote
 
         const std::chrono::seconds OUTDATED_TRANSACTION_POLLING_INTERVAL = std::chrono::seconds(60);
 
+        /* Makes sure an import leaves no write batch open, however it ends.
+           A batch still open when the import is abandoned is discarded - its
+           blocks are still in the main chain storage. */
+        class ImportGuard
+        {
+          public:
+            explicit ImportGuard(IBlockchainCache &segment): m_segment(segment) {}
+
+            ImportGuard(const ImportGuard &) = delete;
+
+            ImportGuard &operator=(const ImportGuard &) = delete;
+
+            ~ImportGuard()
+            {
+                if (!m_batchOpen)
+                {
+                    return;
+                }
+
+                try
+                {
+                    m_segment.discardWriteBatch();
+                }
+                catch (const std::exception &)
+                {
+                    /* Already unwinding from whatever stopped the import */
+                }
+            }
+
+            void beginWriteBatch()
+            {
+                m_segment.beginWriteBatch();
+                m_batchOpen = true;
+            }
+
+            void commitWriteBatch()
+            {
+                m_segment.commitWriteBatch();
+                m_batchOpen = false;
+            }
+
+          private:
+            IBlockchainCache &m_segment;
+
+            bool m_batchOpen = false;
+        };
+
     } // namespace
 
     Core::Core(
@@ -247,7 +298,8 @@ namespace CryptoNote
         blockchainCacheFactory(std::move(blockchainCacheFactory)),
         mainChainStorage(std::move(mainchainStorage)),
         initialized(false),
-        m_transactionValidationThreadPool(transactionValidationThreads)
+        m_transactionValidationThreadPool(transactionValidationThreads),
+        m_walletSyncCache(std::make_unique<WalletSyncCache>(WALLET_SYNC_CACHE_MAX_SIZE))
     {
         upgradeManager->addMajorBlockVersion(BLOCK_MAJOR_VERSION_2, currency.upgradeHeight(BLOCK_MAJOR_VERSION_2));
         upgradeManager->addMajorBlockVersion(BLOCK_MAJOR_VERSION_3, currency.upgradeHeight(BLOCK_MAJOR_VERSION_3));
@@ -718,6 +770,43 @@ namespace CryptoNote
         const bool skipCoinbaseTransactions,
         std::vector<WalletTypes::WalletBlockInfo> &walletBlocks,
         std::optional<WalletTypes::TopBlock> &topBlockInfo) const
+    {
+        uint64_t startIndex;
+        uint64_t actualBlockCount;
+
+        if (!getWalletSyncRange(
+                knownBlockHashes, startHeight, startTimestamp, blockCount, startIndex, actualBlockCount, topBlockInfo))
+        {
+            return false;
+        }
+
+        /* Nothing to return */
+        if (topBlockInfo)
+        {
+            return true;
+        }
+
+        if (!getWalletSyncBlocks(startIndex, actualBlockCount, skipCoinbaseTransactions, walletBlocks))
+        {
+            return false;
+        }
+
+        if (walletBlocks.empty())
+        {
+            topBlockInfo = WalletTypes::TopBlock({getTopBlockHash(), getTopBlockIndex()});
+        }
+
+        return true;
+    }
+
+    bool Core::getWalletSyncRange(
+        const std::vector<Crypto::Hash> &knownBlockHashes,
+        const uint64_t startHeight,
+        const uint64_t startTimestamp,
+        const uint64_t blockCount,
+        uint64_t &startIndex,
+        uint64_t &actualBlockCount,
+        std::optional<WalletTypes::TopBlock> &topBlockInfo) const
     {
         throwIfNotInitialized();
 
@@ -729,7 +818,7 @@ namespace CryptoNote
             uint64_t currentIndex = mainChain->getTopBlockIndex();
             Crypto::Hash currentHash = mainChain->getTopBlockHash();
 
-            uint64_t actualBlockCount = std::min(BLOCKS_SYNCHRONIZING_DEFAULT_COUNT, blockCount);
+            actualBlockCount = std::min(BLOCKS_SYNCHRONIZING_DEFAULT_COUNT, blockCount);
 
             if (actualBlockCount == 0)
             {
@@ -764,7 +853,7 @@ namespace CryptoNote
 
             /* Start returning either from the start height, or the height of the
            last block we know about, whichever is higher */
-            uint64_t startIndex = std::max(
+            startIndex = std::max(
                 /* Plus one so we return the next block - default to zero if it's zero,
            otherwise genesis block will be skipped. */
                 lastKnownBlockHashHeight == 0 ? 0 : lastKnownBlockHashHeight + 1,
@@ -801,18 +890,122 @@ namespace CryptoNote
                 return true;
             }
 
+            return true;
+        }
+        catch (std::exception &e)
+        {
+            logger(Logging::ERROR) << "Failed to get wallet sync data: " << e.what();
+            return false;
+        }
+    }
+
+    bool Core::getWalletSyncBlocks(
+        const uint64_t startIndex,
+        const uint64_t blockCount,
+        const bool skipCoinbaseTransactions,
+        std::vector<WalletTypes::WalletBlockInfo> &walletBlocks) const
+    {
+        const auto chunk = getWalletSyncChunk(startIndex, blockCount, skipCoinbaseTransactions);
+
+        if (!chunk)
+        {
+            return false;
+        }
+
+        try
+        {
+            auto blocks = WalletSyncStream::decodeBlocks(chunk->data);
+
+            walletBlocks.insert(
+                walletBlocks.end(), std::make_move_iterator(blocks.begin()), std::make_move_iterator(blocks.end()));
+
+            return true;
+        }
+        catch (std::exception &e)
+        {
+            logger(Logging::ERROR) << "Failed to decode cached wallet sync data: " << e.what();
+            return false;
+        }
+    }
+
+    std::shared_ptr<const WalletSyncCache::Chunk> Core::getWalletSyncChunk(
+        const uint64_t startIndex,
+        const uint64_t blockCount,
+        const bool skipCoinbaseTransactions) const
+    {
+        if (auto chunk = m_walletSyncCache->get(startIndex, blockCount, skipCoinbaseTransactions))
+        {
+            return chunk;
+        }
+
+        /* Read this before reading the blocks, so if the chain changes while
+           we're reading them, we don't cache stale blocks */
+        const uint64_t generation = m_walletSyncCache->getGeneration();
+
+        std::vector<WalletTypes::WalletBlockInfo> walletBlocks;
+
+        if (!readWalletSyncBlocks(startIndex, blockCount, skipCoinbaseTransactions, walletBlocks))
+        {
+            return nullptr;
+        }
+
+        auto chunk = std::make_shared<WalletSyncCache::Chunk>();
+
+        chunk->data = WalletSyncStream::encodeBlocks(walletBlocks);
+        chunk->blockCount = walletBlocks.size();
+        chunk->reachedTop = walletBlocks.size() < blockCount;
+
+        if (!walletBlocks.empty())
+        {
+            chunk->lastBlockHeight = walletBlocks.back().blockHeight;
+            chunk->lastBlockHash = walletBlocks.back().blockHash;
+        }
+
+        m_walletSyncCache->insert(startIndex, blockCount, skipCoinbaseTransactions, chunk, generation);
+
+        return chunk;
+    }
+
+    std::tuple<uint64_t, uint64_t> Core::getWalletSyncCacheStatistics() const
+    {
+        return m_walletSyncCache->getStatistics();
+    }
+
+    bool Core::readWalletSyncBlocks(
+        const uint64_t startIndex,
+        const uint64_t blockCount,
+        const bool skipCoinbaseTransactions,
+        std::vector<WalletTypes::WalletBlockInfo> &walletBlocks) const
+    {
+        throwIfNotInitialized();
+
+        try
+        {
+            IBlockchainCache *mainChain = chainsLeaves[0];
+
+            const uint64_t currentIndex = mainChain->getTopBlockIndex();
+
+            if (currentIndex < startIndex)
+            {
+                return true;
+            }
+
             std::vector<RawBlock> rawBlocks;
 
             if (skipCoinbaseTransactions)
             {
-                rawBlocks = mainChain->getNonEmptyBlocks(startIndex, actualBlockCount);
+                rawBlocks = mainChain->getNonEmptyBlocks(startIndex, blockCount);
             }
             else
             {
+                const uint64_t endIndex = std::min(blockCount, currentIndex - startIndex + 1) + startIndex;
+
                 rawBlocks = mainChain->getBlocksByHeight(startIndex, endIndex);
             }
 
-            for (const auto rawBlock : rawBlocks)
+            walletBlocks.reserve(walletBlocks.size() + rawBlocks.size());
+
+            for (const auto &rawBlock : rawBlocks)
             {
                 BlockTemplate block;
 
@@ -836,12 +1029,7 @@ namespace CryptoNote
                     walletBlock.transactions.push_back(getRawTransaction(transaction));
                 }
 
-                walletBlocks.push_back(walletBlock);
-            }
-
-            if (walletBlocks.empty())
-            {
-                topBlockInfo = WalletTypes::TopBlock({currentHash, currentIndex});
+                walletBlocks.push_back(std::move(walletBlock));
             }
 
             return true;
@@ -1265,30 +1453,12 @@ namespace CryptoNote
 
         uint64_t cumulativeFee = 0;
 
-        for (const auto &transaction : transactions)
-        {
-            uint64_t fee = 0;
-            auto transactionValidationResult =
-                validateTransaction(transaction, validatorState, cache, m_transactionValidationThreadPool, fee, previousBlockIndex, false);
+        auto transactionValidationResult =
+            validateBlockTransactions(transactions, validatorState, cache, previousBlockIndex, cumulativeFee);
 
-            if (transactionValidationResult)
-            {
-                const auto hash = transaction.getTransactionHash();
-
-                logger(Logging::DEBUGGING) << "Failed to validate transaction " << hash
-                                           << ": " << transactionValidationResult.message();
-
-                if (transactionPool->checkIfTransactionPresent(hash))
-                {
-                    logger(Logging::DEBUGGING) << "Invalid transaction " << hash << " is present in the pool, removing";
-                    transactionPool->removeTransaction(hash);
-                    notifyObservers(makeDelTransactionMessage({hash}, Messages::DeleteTransaction::Reason::NotActual));
-                }
-
-                return transactionValidationResult;
-            }
-
-            cumulativeFee += fee;
+        if (transactionValidationResult)
+        {
+            return transactionValidationResult;
         }
 
         uint64_t reward = 0;
@@ -1395,6 +1565,11 @@ namespace CryptoNote
                         std::swap(chainsLeaves[0], chainsLeaves[endpointIndex]);
                         updateMainChainSet();
 
+                        /* Drop any cached wallet sync data from the old chain
+                           straight away, rather than waiting for the chain switch
+                           notification */
+                        m_walletSyncCache->onChainSwitch(chainsLeaves[0]->getStartBlockIndex());
+
                         updateBlockMedianSize();
 
                         /* Take the current block spent key images and run them
@@ -1589,6 +1764,7 @@ namespace CryptoNote
         switch (opResult)
         {
             case error::AddBlockErrorCode::ADDED_TO_MAIN:
+                m_walletSyncCache->onNewBlock();
                 notifyObservers(makeNewBlockMessage(previousBlockIndex + 1, cachedBlock.getBlockHash()));
                 break;
             case error::AddBlockErrorCode::ADDED_TO_ALTERNATIVE:
@@ -1599,6 +1775,7 @@ namespace CryptoNote
                 auto parent = cache.getParent();
                 auto hashes = cache.getBlockHashes(cache.getStartBlockIndex(), cache.getBlockCount());
                 hashes.insert(hashes.begin(), parent->getTopBlockHash());
+                m_walletSyncCache->onChainSwitch(parent->getTopBlockIndex() + 1);
                 notifyObservers(makeChainSwitchMessage(parent->getTopBlockIndex(), std::move(hashes)));
                 break;
             }
@@ -1713,7 +1890,21 @@ namespace CryptoNote
             return {false, error};
         }
 
-        globalIndexes = chainsLeaves[0]->getRandomOutsByAmount(amount, count, getTopBlockIndex());
+        globalIndexes.clear();
+        publicKeys.clear();
+
+        try
+        {
+            chainsLeaves[0]->getRandomKeyOutputsByAmount(amount, count, getTopBlockIndex(), globalIndexes, publicKeys);
+        }
+        catch (const std::exception &e)
+        {
+            std::string error = std::string("Failed to get random outputs: ") + e.what();
+
+            logger(Logging::DEBUGGING) << error;
+
+            return {false, error};
+        }
 
         if (globalIndexes.empty())
         {
@@ -1732,36 +1923,7 @@ namespace CryptoNote
             return {false, error};
         }
 
-        std::sort(globalIndexes.begin(), globalIndexes.end());
-
-        switch (chainsLeaves[0]->extractKeyOutputKeys(
-            amount, getTopBlockIndex(), {globalIndexes.data(), globalIndexes.size()}, publicKeys))
-        {
-            case ExtractOutputKeysResult::SUCCESS:
-            {
-                return {true, ""};
-            }
-            case ExtractOutputKeysResult::INVALID_GLOBAL_INDEX:
-            {
-                std::string error = "Invalid global index is given";
-
-                logger(Logging::DEBUGGING) << error;
-
-                return {false, error};
-            }
-            case ExtractOutputKeysResult::OUTPUT_LOCKED:
-            {
-                std::string error = "Output is locked";
-
-                logger(Logging::DEBUGGING) << error;
-
-                return {false, error};
-            }
-            default:
-            {
-                return {false, "Unknown error"};
-            }
-        }
+        return {true, ""};
     }
 
     bool Core::getGlobalIndexesForRange(
@@ -2267,7 +2429,7 @@ namespace CryptoNote
         const CachedTransaction &cachedTransaction,
         TransactionValidatorState &state,
         IBlockchainCache *cache,
-        Utilities::ThreadPool<bool> &threadPool,
+        Utilities::WorkStealingThreadPool &threadPool,
         uint64_t &fee,
         uint32_t blockIndex,
         const bool isPoolTransaction)
@@ -2291,6 +2453,70 @@ namespace CryptoNote
         return result.errorCode;
     }
 
+    std::error_code Core::validateBlockTransactions(
+        const std::vector<CachedTransaction> &transactions,
+        TransactionValidatorState &state,
+        IBlockchainCache *cache,
+        const uint32_t blockIndex,
+        uint64_t &cumulativeFee)
+    {
+        const auto rejectTransaction = [&](const CachedTransaction &transaction, const std::error_code &error) {
+            const auto hash = transaction.getTransactionHash();
+
+            logger(Logging::DEBUGGING) << "Failed to validate transaction " << hash << ": " << error.message();
+
+            if (transactionPool->checkIfTransactionPresent(hash))
+            {
+                logger(Logging::DEBUGGING) << "Invalid transaction " << hash << " is present in the pool, removing";
+                transactionPool->removeTransaction(hash);
+                notifyObservers(makeDelTransactionMessage({hash}, Messages::DeleteTransaction::Reason::NotActual));
+            }
+
+            return error;
+        };
+
+        /* Validators are referenced by the signature verifier, so they must
+           not move as more are added */
+        std::deque<ValidateTransaction> validators;
+
+        BlockSignatureVerifier signatureVerifier(m_transactionValidationThreadPool);
+
+        /* Do the cheap checks of each transaction up front, then check the
+           inputs of every transaction in the block as one batch, rather than
+           a transaction at a time */
+        for (const auto &transaction : transactions)
+        {
+            auto &validator = validators.emplace_back(
+                transaction,
+                state,
+                cache,
+                currency,
+                checkpoints,
+                m_transactionValidationThreadPool,
+                blockIndex,
+                blockMedianSize,
+                false);
+
+            const auto result = validator.validateWithoutExpensiveChecks();
+
+            if (!result.valid)
+            {
+                return rejectTransaction(transaction, result.errorCode);
+            }
+
+            signatureVerifier.addTransaction(validator);
+
+            cumulativeFee += result.fee;
+        }
+
+        if (const auto failed = signatureVerifier.verify())
+        {
+            return rejectTransaction(transactions[*failed], validators[*failed].getValidationResult().errorCode);
+        }
+
+        return error::TransactionValidationError::VALIDATION_SUCCESS;
+    }
+
     uint32_t Core::findBlockchainSupplement(const std::vector<Crypto::Hash> &remoteBlockIds) const
     {
         /* Requester doesn't know anything about the chain yet */
@@ -2491,66 +2717,210 @@ namespace CryptoNote
         cutSegment(*chainsLeaves[0], commonIndex + 1);
 
         auto previousBlockHash = getBlockHash(mainChainStorage->getBlockByIndex(commonIndex));
-        auto blockCount = mainChainStorage->getBlockCount();
-        for (uint32_t i = commonIndex + 1; i < blockCount; ++i)
+        const uint32_t blockCount = mainChainStorage->getBlockCount();
+
+        if (commonIndex + 1 >= blockCount)
         {
-            RawBlock rawBlock = mainChainStorage->getBlockByIndex(i);
-            auto blockTemplate = extractBlockTemplate(rawBlock);
-            CachedBlock cachedBlock(blockTemplate);
+            return;
+        }
+
+        /* Time spent in each stage of the import. prepareTime is summed
+           across the worker threads, so can exceed the wall clock time. */
+        std::atomic<uint64_t> prepareTime = 0;
+        std::chrono::steady_clock::duration readTime {};
+        std::chrono::steady_clock::duration waitTime {};
+        std::chrono::steady_clock::duration applyTime {};
+        std::chrono::steady_clock::duration commitTime {};
+
+        /* Reads a batch of blocks from the main chain storage, and queues
+           them to be deserialized and hashed by the worker threads */
+        const auto prepareBatch = [&](const uint32_t startIndex) {
+            const auto start = std::chrono::steady_clock::now();
+
+            const uint32_t endIndex = std::min(blockCount, startIndex + IMPORT_BLOCKS_BATCH_SIZE);
+
+            auto batch = std::make_unique<ImportBatch>();
+            batch->startIndex = startIndex;
+            batch->blocks = std::vector<PreparedBlock>(endIndex - startIndex);
 
-            if (blockTemplate.previousBlockHash != previousBlockHash)
+            for (uint32_t i = startIndex; i < endIndex; i++)
             {
-                logger(Logging::ERROR)
-                    << "Local blockchain corruption detected. " << std::endl
-                    << "Block with index " << i << " and hash " << cachedBlock.getBlockHash()
-                    << " has previous block hash " << blockTemplate.previousBlockHash << ", but parent has hash "
-                    << previousBlockHash << "." << std::endl
-                    << "Please try to repair this issue by starting the node with the option: --rewind-to-height " << i
-                    << std::endl
-                    << "If the above does not repair the issue, please launch the node with the option: --resync"
-                    << std::endl;
-                throw std::system_error(make_error_code(error::CoreErrorCode::CORRUPTED_BLOCKCHAIN));
+                batch->blocks[i - startIndex].rawBlock = mainChainStorage->getBlockByIndex(i);
             }
 
-            previousBlockHash = cachedBlock.getBlockHash();
+            readTime += std::chrono::steady_clock::now() - start;
 
-            std::vector<CachedTransaction> transactions;
-            uint64_t cumulativeSize = 0;
-            if (!extractTransactions(rawBlock.transactions, transactions, cumulativeSize))
+            PreparedBlock *blocks = batch->blocks.data();
+
+            m_transactionValidationThreadPool.submitBulk(
+                batch->preparing, batch->blocks.size(), [this, blocks, &prepareTime](const size_t i) {
+                    const auto start = std::chrono::steady_clock::now();
+
+                    blocks[i].prepared = prepareBlockForImport(blocks[i]);
+
+                    prepareTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count();
+                });
+
+            return batch;
+        };
+
+        const auto toMilliseconds = [](const auto duration) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+        };
+
+        const auto importStart = std::chrono::steady_clock::now();
+
+        auto progressStart = importStart;
+        uint32_t progressStartIndex = commonIndex + 1;
+
+        /* Discards the write batch if the import stops partway */
+        ImportGuard importGuard(*chainsLeaves[0]);
+
+        /* While one batch is applied, the next is being read and prepared */
+        std::unique_ptr<ImportBatch> current = prepareBatch(commonIndex + 1);
+
+        while (current)
+        {
+            const uint32_t nextIndex = current->startIndex + static_cast<uint32_t>(current->blocks.size());
+
+            std::unique_ptr<ImportBatch> next = nextIndex < blockCount ? prepareBatch(nextIndex) : nullptr;
+
+            auto start = std::chrono::steady_clock::now();
+
+            /* Usually finished while the previous batch was applied */
+            m_transactionValidationThreadPool.wait(current->preparing);
+
+            waitTime += std::chrono::steady_clock::now() - start;
+
+            importGuard.beginWriteBatch();
+
+            for (size_t j = 0; j < current->blocks.size(); j++)
             {
-                logger(Logging::ERROR) << "Couldn't deserialize raw block transactions in block "
-                                       << cachedBlock.getBlockHash();
-                throw std::system_error(make_error_code(error::AddBlockErrorCode::DESERIALIZATION_FAILED));
+                const uint32_t i = current->startIndex + static_cast<uint32_t>(j);
+
+                PreparedBlock &block = current->blocks[j];
+
+                if (!block.prepared)
+                {
+                    logger(Logging::ERROR) << "Couldn't deserialize block with index " << i;
+                    throw std::system_error(make_error_code(error::AddBlockErrorCode::DESERIALIZATION_FAILED));
+                }
+
+                start = std::chrono::steady_clock::now();
+
+                const CachedBlock &cachedBlock = *block.cachedBlock;
+
+                if (block.blockTemplate.previousBlockHash != previousBlockHash)
+                {
+                    logger(Logging::ERROR)
+                        << "Local blockchain corruption detected. " << std::endl
+                        << "Block with index " << i << " and hash " << cachedBlock.getBlockHash()
+                        << " has previous block hash " << block.blockTemplate.previousBlockHash
+                        << ", but parent has hash " << previousBlockHash << "." << std::endl
+                        << "Please try to repair this issue by starting the node with the option: --rewind-to-height "
+                        << i << std::endl
+                        << "If the above does not repair the issue, please launch the node with the option: --resync"
+                        << std::endl;
+                    throw std::system_error(make_error_code(error::CoreErrorCode::CORRUPTED_BLOCKCHAIN));
+                }
+
+                previousBlockHash = cachedBlock.getBlockHash();
+
+                auto currentDifficulty = chainsLeaves[0]->getDifficultyForNextBlock(i - 1);
+
+                int64_t emissionChange = getEmissionChange(
+                    currency, *chainsLeaves[0], i - 1, cachedBlock, block.cumulativeSize, block.cumulativeFee);
+
+                chainsLeaves[0]->pushBlock(
+                    cachedBlock,
+                    block.transactions,
+                    block.spentOutputs,
+                    block.cumulativeSize,
+                    emissionChange,
+                    currentDifficulty,
+                    std::move(block.rawBlock));
+
+                applyTime += std::chrono::steady_clock::now() - start;
+
+                if (i % 1000 == 0)
+                {
+                    const auto now = std::chrono::steady_clock::now();
+
+                    const double seconds = std::chrono::duration<double>(now - progressStart).count();
+
+                    logger(Logging::INFO) << "Imported block with index " << i << " / " << (blockCount - 1) << " ("
+                                          << static_cast<uint64_t>((i - progressStartIndex) / std::max(seconds, 0.001))
+                                          << " blocks/s)";
+
+                    progressStart = now;
+                    progressStartIndex = i;
+                }
             }
 
-            cumulativeSize += getObjectBinarySize(blockTemplate.baseTransaction);
-            TransactionValidatorState spentOutputs = extractSpentOutputs(transactions);
-            auto currentDifficulty = chainsLeaves[0]->getDifficultyForNextBlock(i - 1);
+            start = std::chrono::steady_clock::now();
 
-            uint64_t cumulativeFee = std::accumulate(
-                transactions.begin(),
-                transactions.end(),
-                UINT64_C(0),
-                [](uint64_t fee, const CachedTransaction &transaction) {
-                    return fee + transaction.getTransactionFee();
-                });
+            importGuard.commitWriteBatch();
 
-            int64_t emissionChange =
-                getEmissionChange(currency, *chainsLeaves[0], i - 1, cachedBlock, cumulativeSize, cumulativeFee);
-            chainsLeaves[0]->pushBlock(
-                cachedBlock,
-                transactions,
-                spentOutputs,
-                cumulativeSize,
-                emissionChange,
-                currentDifficulty,
-                std::move(rawBlock));
+            commitTime += std::chrono::steady_clock::now() - start;
+
+            current = std::move(next);
+        }
+
+        const auto importTime = std::chrono::steady_clock::now() - importStart;
+
+        const uint32_t importedCount = blockCount - (commonIndex + 1);
+
+        logger(Logging::INFO) << "Imported " << importedCount << " blocks in " << toMilliseconds(importTime) / 1000
+                              << " seconds ("
+                              << static_cast<uint64_t>(
+                                     importedCount / std::max(std::chrono::duration<double>(importTime).count(), 0.001))
+                              << " blocks/s)";
+
+        logger(Logging::INFO) << "Import time spent reading storage: " << toMilliseconds(readTime)
+                              << " ms, deserializing and hashing: "
+                              << toMilliseconds(std::chrono::nanoseconds(prepareTime.load()))
+                              << " ms (across all threads), waiting for workers: " << toMilliseconds(waitTime)
+                              << " ms, applying blocks: " << toMilliseconds(applyTime)
+                              << " ms, committing to database: " << toMilliseconds(commitTime) << " ms";
+    }
 
-            if (i % 1000 == 0)
+    bool Core::prepareBlockForImport(PreparedBlock &block)
+    {
+        try
+        {
+            block.blockTemplate = extractBlockTemplate(block.rawBlock);
+
+            /* Hashing is the expensive part, so do it here rather than when
+               the block is pushed */
+            block.cachedBlock.emplace(block.blockTemplate);
+            block.cachedBlock->getBlockHash();
+
+            if (!extractTransactions(block.rawBlock.transactions, block.transactions, block.cumulativeSize))
             {
-                logger(Logging::INFO) << "Imported block with index " << i << " / " << (blockCount - 1);
+                logger(Logging::ERROR) << "Couldn't deserialize raw block transactions in block "
+                                       << block.cachedBlock->getBlockHash();
+                return false;
             }
+
+            block.cumulativeSize += getObjectBinarySize(block.blockTemplate.baseTransaction);
+
+            for (const auto &transaction : block.transactions)
+            {
+                transaction.getTransactionHash();
+                block.cumulativeFee += transaction.getTransactionFee();
+            }
+
+            block.spentOutputs = extractSpentOutputs(block.transactions);
+        }
+        catch (const std::exception &e)
+        {
+            logger(Logging::ERROR) << "Failed to prepare block for import: " << e.what();
+            return false;
         }
+
+        return true;
     }
 
     void Core::cutSegment(IBlockchainCache &segment, uint32_t startIndex)
@@ -21,13 +21,15 @@
 #include "IUpgradeManager.h"
 #include "MessageQueue.h"
 #include "TransactionValidatiorState.h"
+#include "WalletSyncCache.h"
 
 #include <WalletTypes.h>
 #include <ctime>
 #include <logging/LoggerMessage.h>
+#include <optional>
 #include <system/ContextGroup.h>
 #include <unordered_map>
-#include <utilities/ThreadPool.h>
+#include <utilities/WorkStealingThreadPool.h>
 #include <vector>
 
 namespace CryptoNote
@@ -113,6 +115,36 @@ namespace CryptoNote
             std::vector<WalletTypes::WalletBlockInfo> &walletBlocks,
             std::optional<WalletTypes::TopBlock> &topBlockInfo) const override;
 
+        /* Works out which blocks a wallet sync request should be served.
+           If there are no blocks to return, topBlockInfo is filled in. */
+        bool getWalletSyncRange(
+            const std::vector<Crypto::Hash> &knownBlockHashes,
+            const uint64_t startHeight,
+            const uint64_t startTimestamp,
+            const uint64_t blockCount,
+            uint64_t &startIndex,
+            uint64_t &actualBlockCount,
+            std::optional<WalletTypes::TopBlock> &topBlockInfo) const;
+
+        /* Appends up to blockCount blocks, starting from startIndex, to
+           walletBlocks. With skipCoinbaseTransactions, empty blocks are
+           skipped and don't count towards blockCount. */
+        bool getWalletSyncBlocks(
+            const uint64_t startIndex,
+            const uint64_t blockCount,
+            const bool skipCoinbaseTransactions,
+            std::vector<WalletTypes::WalletBlockInfo> &walletBlocks) const;
+
+        /* As getWalletSyncBlocks, but returns the blocks in the binary wallet
+           sync format, from the cache if possible. Returns nullptr on failure. */
+        std::shared_ptr<const WalletSyncCache::Chunk> getWalletSyncChunk(
+            const uint64_t startIndex,
+            const uint64_t blockCount,
+            const bool skipCoinbaseTransactions) const;
+
+        /* {hits, misses} */
+        std::tuple<uint64_t, uint64_t> getWalletSyncCacheStatistics() const;
+
         virtual bool getRawBlocks(
             const std::vector<Crypto::Hash> &knownBlockHashes,
             const uint64_t startHeight,
@@ -255,7 +287,9 @@ namespace CryptoNote
 
         std::unique_ptr<IMainChainStorage> mainChainStorage;
 
-        Utilities::ThreadPool<bool> m_transactionValidationThreadPool;
+        Utilities::WorkStealingThreadPool m_transactionValidationThreadPool;
+
+        std::unique_ptr<WalletSyncCache> m_walletSyncCache;
 
         bool initialized;
 
@@ -274,11 +308,20 @@ namespace CryptoNote
             const CachedTransaction &transaction,
             TransactionValidatorState &state,
             IBlockchainCache *cache,
-            Utilities::ThreadPool<bool> &threadPool,
+            Utilities::WorkStealingThreadPool &threadPool,
             uint64_t &fee,
             uint32_t blockIndex,
             const bool isPoolTransaction);
 
+        /* Validates every transaction of a block, removing an invalid one
+           from the pool. cumulativeFee is increased by the transactions' fees */
+        std::error_code validateBlockTransactions(
+            const std::vector<CachedTransaction> &transactions,
+            TransactionValidatorState &state,
+            IBlockchainCache *cache,
+            const uint32_t blockIndex,
+            uint64_t &cumulativeFee);
+
         uint32_t findBlockchainSupplement(const std::vector<Crypto::Hash> &remoteBlockIds) const;
 
         std::vector<Crypto::Hash> getBlockHashes(uint32_t startBlockIndex, uint32_t maxCount) const;
@@ -404,12 +447,60 @@ namespace CryptoNote
 
         void initRootSegment();
 
+        /* A block read from the main chain storage, deserialized and hashed
+           by a worker thread, ready to be pushed by importBlocksFromStorage */
+        struct PreparedBlock
+        {
+            RawBlock rawBlock;
+
+            BlockTemplate blockTemplate;
+
+            /* References blockTemplate, so the PreparedBlock must not be
+               moved once this is set */
+            std::optional<CachedBlock> cachedBlock;
+
+            /* Whether the worker deserialized the block successfully */
+            bool prepared = false;
+
+            std::vector<CachedTransaction> transactions;
+
+            TransactionValidatorState spentOutputs;
+
+            uint64_t cumulativeSize = 0;
+
+            uint64_t cumulativeFee = 0;
+        };
+
+        struct ImportBatch
+        {
+            uint32_t startIndex = 0;
+
+            std::vector<PreparedBlock> blocks;
+
+            /* The workers preparing blocks */
+            Utilities::WaitGroup preparing;
+
+            /* The workers reference blocks, so wait for them before it's freed */
+            ~ImportBatch()
+            {
+                preparing.wait();
+            }
+        };
+
         void importBlocksFromStorage();
 
+        bool prepareBlockForImport(PreparedBlock &block);
+
         void cutSegment(IBlockchainCache &segment, uint32_t startIndex);
 
         void switchMainChainStorage(uint32_t splitBlockIndex, IBlockchainCache &newChain);
 
+        bool readWalletSyncBlocks(
+            const uint64_t startIndex,
+            const uint64_t blockCount,
+            const bool skipCoinbaseTransactions,
+            std::vector<WalletTypes::WalletBlockInfo> &walletBlocks) const;
+
         std::mutex m_submitBlockMutex;
     };
 
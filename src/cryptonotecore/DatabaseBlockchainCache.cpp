@@ -23,6 +23,10 @@ namespace CryptoNote
     {
         const uint32_t ONE_DAY_SECONDS = 60 * 60 * 24;
 
+        /* How many outputs to read from the database at once when loading an
+           amount into the key output index */
+        const uint32_t KEY_OUTPUT_INDEX_LOAD_BATCH_SIZE = 10000;
+
         const CachedBlockInfo NULL_CACHED_BLOCK_INFO {Constants::NULL_HASH, 0, 0, 0, 0, 0};
 
         bool requestPackedOutputs(
@@ -671,6 +675,7 @@ namespace CryptoNote
     std::unique_ptr<IBlockchainCache> DatabaseBlockchainCache::split(uint32_t splitBlockIndex)
     {
         assert(splitBlockIndex <= getTopBlockIndex());
+        assert(!pendingWrites);
         logger(Logging::DEBUGGING) << "split at index " << splitBlockIndex
                                    << " started, top block index: " << getTopBlockIndex();
 
@@ -738,6 +743,11 @@ namespace CryptoNote
 
         cutTail(unitsCache, currentTop + 1 - splitBlockIndex);
 
+        for (const auto &[amount, boundary] : keyIndexSplitBoundaries)
+        {
+            keyOutputIndex.truncate(amount, boundary);
+        }
+
         children.push_back(cache.get());
         logger(Logging::TRACE) << "Delete successfull";
 
@@ -946,7 +956,8 @@ namespace CryptoNote
         const CachedTransaction &cachedTransaction,
         uint32_t blockIndex,
         uint16_t transactionBlockIndex,
-        BlockchainWriteBatch &batch)
+        BlockchainWriteBatch &batch,
+        std::vector<PushedKeyOutput> &pushedKeyOutputs)
     {
         logger(Logging::DEBUGGING) << "push transaction with hash " << cachedTransaction.getTransactionHash();
         const auto &tx = cachedTransaction.getTransaction();
@@ -997,6 +1008,11 @@ namespace CryptoNote
                 outputInfo.outputIndex = poi.outputIndex;
 
                 batch.insertKeyOutputInfo(output.amount, globalIndex, outputInfo);
+
+                pushedKeyOutputs.emplace_back(
+                    output.amount,
+                    globalIndex,
+                    KeyOutputIndex::Output {outputInfo.publicKey, blockIndex, outputInfo.unlockTime});
             }
         }
 
@@ -1067,17 +1083,30 @@ namespace CryptoNote
         const Crypto::Hash &transactionHash,
         const Crypto::Hash &paymentId)
     {
-        BlockchainReadBatch readBatch;
         uint32_t count = 0;
 
-        auto readResult = readDatabase(readBatch.requestTransactionCountByPaymentId(paymentId));
-        if (readResult.getTransactionCountByPaymentIds().count(paymentId) != 0)
+        if (pendingWrites && pendingWrites->paymentIdTransactionCounts.count(paymentId) != 0)
         {
-            count = readResult.getTransactionCountByPaymentIds().at(paymentId);
+            count = pendingWrites->paymentIdTransactionCounts.at(paymentId);
+        }
+        else
+        {
+            BlockchainReadBatch readBatch;
+
+            auto readResult = readDatabase(readBatch.requestTransactionCountByPaymentId(paymentId));
+            if (readResult.getTransactionCountByPaymentIds().count(paymentId) != 0)
+            {
+                count = readResult.getTransactionCountByPaymentIds().at(paymentId);
+            }
         }
 
         count += 1;
 
+        if (pendingWrites)
+        {
+            pendingWrites->paymentIdTransactionCounts[paymentId] = count;
+        }
+
         batch.insertPaymentId(transactionHash, paymentId, count);
     }
 
@@ -1086,19 +1115,32 @@ namespace CryptoNote
         uint64_t timestamp,
         const Crypto::Hash &blockHash)
     {
-        BlockchainReadBatch readBatch;
-        readBatch.requestBlockHashesByTimestamp(timestamp);
-
         std::vector<Crypto::Hash> blockHashes;
-        auto readResult = readDatabase(readBatch);
 
-        if (readResult.getBlockHashesByTimestamp().count(timestamp) != 0)
+        if (pendingWrites && pendingWrites->blockHashesByTimestamp.count(timestamp) != 0)
+        {
+            blockHashes = pendingWrites->blockHashesByTimestamp.at(timestamp);
+        }
+        else
         {
-            blockHashes = readResult.getBlockHashesByTimestamp().at(timestamp);
+            BlockchainReadBatch readBatch;
+            readBatch.requestBlockHashesByTimestamp(timestamp);
+
+            auto readResult = readDatabase(readBatch);
+
+            if (readResult.getBlockHashesByTimestamp().count(timestamp) != 0)
+            {
+                blockHashes = readResult.getBlockHashesByTimestamp().at(timestamp);
+            }
         }
 
         blockHashes.emplace_back(blockHash);
 
+        if (pendingWrites)
+        {
+            pendingWrites->blockHashesByTimestamp[timestamp] = blockHashes;
+        }
+
         batch.insertTimestamp(timestamp, blockHashes);
     }
 
@@ -1111,7 +1153,14 @@ namespace CryptoNote
         uint64_t blockDifficulty,
         RawBlock &&rawBlock)
     {
-        BlockchainWriteBatch batch;
+        BlockchainWriteBatch blockBatch;
+        std::vector<PushedKeyOutput> blockKeyOutputs;
+
+        /* When a write batch is open, add to it instead of writing this
+           block on its own */
+        BlockchainWriteBatch &batch = pendingWrites ? pendingWrites->batch : blockBatch;
+        std::vector<PushedKeyOutput> &pushedKeyOutputs = pendingWrites ? pendingWrites->keyOutputs : blockKeyOutputs;
+
         logger(Logging::DEBUGGING) << "push block with hash " << cachedBlock.getBlockHash() << ", and "
                                    << cachedTransactions.size() + 1 << " transactions"; //+1 for base transaction
 
@@ -1142,39 +1191,61 @@ namespace CryptoNote
         batch.insertRawBlock(getTopBlockIndex() + 1, std::move(rawBlock));
 
         auto transactionIndex = 0;
-        pushTransaction(cachedBaseTransaction, getTopBlockIndex() + 1, transactionIndex++, batch);
+        pushTransaction(cachedBaseTransaction, getTopBlockIndex() + 1, transactionIndex++, batch, pushedKeyOutputs);
 
         for (const auto &transaction : cachedTransactions)
         {
-            pushTransaction(transaction, getTopBlockIndex() + 1, transactionIndex++, batch);
+            pushTransaction(transaction, getTopBlockIndex() + 1, transactionIndex++, batch, pushedKeyOutputs);
         }
 
-        auto closestBlockIndexDb =
-            requestClosestBlockIndexByTimestamp(roundToMidnight(cachedBlock.getBlock().timestamp), database);
-        if (!closestBlockIndexDb.second)
-        {
-            logger(Logging::ERROR) << "push block " << cachedBlock.getBlockHash()
-                                   << " request closest block index by timestamp failed";
-            throw std::runtime_error("Couldn't get closest to timestamp block index");
-        }
+        const uint64_t midnight = roundToMidnight(cachedBlock.getBlock().timestamp);
 
-        if (!closestBlockIndexDb.first)
+        if (!pendingWrites || pendingWrites->closestTimestamps.count(midnight) == 0)
         {
-            batch.insertClosestTimestampBlockIndex(
-                roundToMidnight(cachedBlock.getBlock().timestamp), getTopBlockIndex() + 1);
+            auto closestBlockIndexDb = requestClosestBlockIndexByTimestamp(midnight, database);
+            if (!closestBlockIndexDb.second)
+            {
+                logger(Logging::ERROR) << "push block " << cachedBlock.getBlockHash()
+                                       << " request closest block index by timestamp failed";
+                throw std::runtime_error("Couldn't get closest to timestamp block index");
+            }
+
+            if (!closestBlockIndexDb.first)
+            {
+                batch.insertClosestTimestampBlockIndex(midnight, getTopBlockIndex() + 1);
+            }
+
+            if (pendingWrites)
+            {
+                pendingWrites->closestTimestamps.insert(midnight);
+            }
         }
 
         insertBlockTimestamp(batch, cachedBlock.getBlock().timestamp, cachedBlock.getBlockHash());
 
-        auto res = database.write(batch);
-        if (res)
+        if (pendingWrites)
         {
-            logger(Logging::ERROR) << "push block " << cachedBlock.getBlockHash() << " write failed: " << res.message();
-            throw std::runtime_error(res.message());
+            pendingWrites->blockCount++;
+        }
+        else
+        {
+            auto res = database.write(batch);
+            if (res)
+            {
+                logger(Logging::ERROR) << "push block " << cachedBlock.getBlockHash()
+                                       << " write failed: " << res.message();
+                throw std::runtime_error(res.message());
+            }
+
+            for (const auto &[amount, globalIndex, output] : pushedKeyOutputs)
+            {
+                keyOutputIndex.push(amount, globalIndex, output);
+            }
         }
 
         topBlockIndex = *topBlockIndex + 1;
         topBlockHash = cachedBlock.getBlockHash();
+
         logger(Logging::DEBUGGING) << "push block " << cachedBlock.getBlockHash() << " completed";
 
         unitsCache.push_back(blockInfo);
@@ -1483,6 +1554,15 @@ namespace CryptoNote
 
     CachedBlockInfo DatabaseBlockchainCache::getCachedBlockInfo(uint32_t index) const
     {
+        /* The most recent blocks are kept in memory, and blocks in an open
+           write batch are only there */
+        const uint32_t cacheStartIndex = (getTopBlockIndex() + 1) - static_cast<uint32_t>(unitsCache.size());
+
+        if (index >= cacheStartIndex && index <= getTopBlockIndex())
+        {
+            return unitsCache[index - cacheStartIndex];
+        }
+
         auto batch = BlockchainReadBatch().requestCachedBlock(index);
         auto result = readDatabase(batch);
         return result.getCachedBlocks().at(index);
@@ -1806,6 +1886,67 @@ namespace CryptoNote
 
     void DatabaseBlockchainCache::load() {}
 
+    void DatabaseBlockchainCache::beginWriteBatch()
+    {
+        assert(!pendingWrites);
+
+        pendingWrites = std::make_unique<PendingWrites>();
+    }
+
+    void DatabaseBlockchainCache::commitWriteBatch()
+    {
+        assert(pendingWrites);
+
+        /* Blocks in the batch must still be in the units cache, since that's
+           the only place their info can be read from until they're written */
+        assert(pendingWrites->blockCount <= unitsCacheSize);
+
+        if (pendingWrites->blockCount == 0)
+        {
+            pendingWrites.reset();
+            return;
+        }
+
+        /* Left open if the write fails, so discardWriteBatch() can undo the
+           blocks pushed */
+        auto res = database.write(pendingWrites->batch);
+        if (res)
+        {
+            logger(Logging::ERROR) << "commit write batch of " << pendingWrites->blockCount
+                                   << " blocks failed: " << res.message();
+            throw std::runtime_error(res.message());
+        }
+
+        const auto pending = std::move(pendingWrites);
+
+        for (const auto &[amount, globalIndex, output] : pending->keyOutputs)
+        {
+            keyOutputIndex.push(amount, globalIndex, output);
+        }
+
+        logger(Logging::DEBUGGING) << "committed write batch of " << pending->blockCount << " blocks";
+    }
+
+    void DatabaseBlockchainCache::discardWriteBatch()
+    {
+        assert(pendingWrites);
+
+        const auto pending = std::move(pendingWrites);
+
+        /* A block only reaches the units cache once it is fully in the
+           batch. The counters may include part of a block, so are read back
+           from the database when next needed. */
+        cutTail(unitsCache, pending->blockCount);
+
+        topBlockIndex = boost::none;
+        topBlockHash = boost::none;
+        transactionsCount = boost::none;
+        keyOutputAmountsCount = boost::none;
+        keyOutputCountsForAmounts.clear();
+
+        logger(Logging::DEBUGGING) << "discarded write batch of " << pending->blockCount << " blocks";
+    }
+
     std::vector<BinaryArray> DatabaseBlockchainCache::getRawTransactions(
         const std::vector<Crypto::Hash> &transactions,
         std::vector<Crypto::Hash> &missedTransactions) const
@@ -1969,6 +2110,81 @@ namespace CryptoNote
         return resultOuts;
     }
 
+    void DatabaseBlockchainCache::getRandomKeyOutputsByAmount(
+        uint64_t amount,
+        size_t count,
+        uint32_t blockIndex,
+        std::vector<uint32_t> &globalIndexes,
+        std::vector<Crypto::PublicKey> &publicKeys) const
+    {
+        uint32_t upperBlockIndex = 0;
+        if (blockIndex > currency.minedMoneyUnlockWindow())
+        {
+            upperBlockIndex = blockIndex - currency.minedMoneyUnlockWindow();
+        }
+
+        const auto isUnlocked = [this, blockIndex](const uint64_t unlockTime) {
+            return isTransactionSpendTimeUnlocked(unlockTime, blockIndex);
+        };
+
+        /* Only the first request for each amount hits the database */
+        while (!keyOutputIndex.pickRandomOutputs(amount, count, upperBlockIndex, isUnlocked, globalIndexes, publicKeys))
+        {
+            loadKeyOutputIndex(amount);
+        }
+    }
+
+    void DatabaseBlockchainCache::loadKeyOutputIndex(Amount amount) const
+    {
+        auto countBatch = BlockchainReadBatch().requestKeyOutputGlobalIndexesCountForAmount(amount);
+        const auto outputsCount = readDatabase(countBatch).getKeyOutputGlobalIndexesCountForAmounts();
+
+        const auto it = outputsCount.find(amount);
+        const uint32_t count = it != outputsCount.end() ? it->second : 0;
+
+        logger(Logging::DEBUGGING) << "Loading " << count << " key outputs for amount " << amount
+                                   << " into key output index";
+
+        std::vector<KeyOutputIndex::Output> outputs;
+        outputs.reserve(count);
+
+        for (uint32_t start = 0; start < count; start += KEY_OUTPUT_INDEX_LOAD_BATCH_SIZE)
+        {
+            const uint32_t end = std::min(count, start + KEY_OUTPUT_INDEX_LOAD_BATCH_SIZE);
+
+            BlockchainReadBatch batch;
+
+            for (uint32_t globalIndex = start; globalIndex < end; globalIndex++)
+            {
+                batch.requestKeyOutputGlobalIndexForAmount(amount, globalIndex);
+                batch.requestKeyOutputInfo(amount, globalIndex);
+            }
+
+            const auto result = readDatabase(batch);
+            const auto &packedOutputs = result.getKeyOutputGlobalIndexesForAmounts();
+            const auto &outputInfos = result.getKeyOutputInfo();
+
+            for (uint32_t globalIndex = start; globalIndex < end; globalIndex++)
+            {
+                const auto key = std::make_pair(amount, globalIndex);
+                const auto packedOutput = packedOutputs.find(key);
+                const auto outputInfo = outputInfos.find(key);
+
+                if (packedOutput == packedOutputs.end() || outputInfo == outputInfos.end())
+                {
+                    logger(Logging::ERROR) << "loadKeyOutputIndex: key output " << globalIndex << " for amount "
+                                           << amount << " not found";
+                    throw std::runtime_error("Key output not found");
+                }
+
+                outputs.push_back(KeyOutputIndex::Output {
+                    outputInfo->second.publicKey, packedOutput->second.blockIndex, outputInfo->second.unlockTime});
+            }
+        }
+
+        keyOutputIndex.load(amount, std::move(outputs));
+    }
+
     ExtractOutputKeysResult DatabaseBlockchainCache::extractKeyOutputs(
         uint64_t amount,
         uint32_t blockIndex,
@@ -2238,7 +2454,10 @@ namespace CryptoNote
         auto baseTransaction = genesisBlock.getBlock().baseTransaction;
         auto cachedBaseTransaction = CachedTransaction {std::move(baseTransaction)};
 
-        pushTransaction(cachedBaseTransaction, 0, 0, batch);
+        /* Nothing can be loaded into the key output index yet */
+        std::vector<PushedKeyOutput> pushedKeyOutputs;
+
+        pushTransaction(cachedBaseTransaction, 0, 0, batch, pushedKeyOutputs);
 
         batch.insertCachedBlock(blockInfo, 0, {cachedBaseTransaction.getTransactionHash()});
         batch.insertRawBlock(0, {toBinaryArray(genesisBlock.getBlock()), {}});
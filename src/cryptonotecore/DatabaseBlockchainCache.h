@@ -19,6 +19,7 @@
 
 #include "Currency.h"
 #include "IBlockchainCache.h"
+#include "KeyOutputIndex.h"
 #include "common/StringView.h"
 #include "cryptonotecore/UpgradeManager.h"
 
@@ -27,6 +28,7 @@
 #include <cryptonotecore/BlockchainWriteBatch.h>
 #include <cryptonotecore/DatabaseCacheData.h>
 #include <cryptonotecore/IBlockchainCacheFactory.h>
+#include <unordered_set>
 
 namespace CryptoNote
 {
@@ -193,6 +195,12 @@ namespace CryptoNote
 
         virtual void load() override;
 
+        virtual void beginWriteBatch() override;
+
+        virtual void commitWriteBatch() override;
+
+        virtual void discardWriteBatch() override;
+
         virtual std::vector<BinaryArray> getRawTransactions(
             const std::vector<Crypto::Hash> &transactions,
             std::vector<Crypto::Hash> &missedTransactions) const override;
@@ -214,6 +222,13 @@ namespace CryptoNote
         virtual std::vector<uint32_t>
             getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const override;
 
+        virtual void getRandomKeyOutputsByAmount(
+            uint64_t amount,
+            size_t count,
+            uint32_t blockIndex,
+            std::vector<uint32_t> &globalIndexes,
+            std::vector<Crypto::PublicKey> &publicKeys) const override;
+
         virtual ExtractOutputKeysResult extractKeyOutputs(
             uint64_t amount,
             uint32_t blockIndex,
@@ -258,6 +273,30 @@ namespace CryptoNote
 
         const size_t unitsCacheSize = 1000;
 
+        /* Key outputs of the amounts requested by getRandomKeyOutputsByAmount */
+        mutable KeyOutputIndex keyOutputIndex;
+
+        using PushedKeyOutput = std::tuple<Amount, GlobalOutputIndex, KeyOutputIndex::Output>;
+
+        /* Blocks pushed since beginWriteBatch(), which aren't in the database
+           yet, along with the values pushBlock() would otherwise read back */
+        struct PendingWrites
+        {
+            BlockchainWriteBatch batch;
+
+            std::vector<PushedKeyOutput> keyOutputs;
+
+            std::unordered_map<Crypto::Hash, uint32_t> paymentIdTransactionCounts;
+
+            std::unordered_map<uint64_t, std::vector<Crypto::Hash>> blockHashesByTimestamp;
+
+            std::unordered_set<uint64_t> closestTimestamps;
+
+            uint32_t blockCount = 0;
+        };
+
+        std::unique_ptr<PendingWrites> pendingWrites;
+
         struct ExtendedPushedBlockInfo;
 
         ExtendedPushedBlockInfo getExtendedPushedBlockInfo(uint32_t blockIndex) const;
@@ -274,7 +313,10 @@ namespace CryptoNote
             const CachedTransaction &cachedTransaction,
             uint32_t blockIndex,
             uint16_t transactionBlockIndex,
-            BlockchainWriteBatch &batch);
+            BlockchainWriteBatch &batch,
+            std::vector<PushedKeyOutput> &pushedKeyOutputs);
+
+        void loadKeyOutputIndex(Amount amount) const;
 
         uint32_t insertKeyOutputToGlobalIndex(
             uint64_t amount,
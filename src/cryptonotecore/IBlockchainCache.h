@@ -222,6 +222,18 @@ namespace CryptoNote
 
         virtual void load() = 0;
 
+        /* Blocks pushed after this are gathered up and written in one go by
+           commitWriteBatch(). Only pushBlock() and the block info used to
+           validate the next block can be relied upon until then. Does
+           nothing for in memory caches. */
+        virtual void beginWriteBatch() = 0;
+
+        virtual void commitWriteBatch() = 0;
+
+        /* Forgets the blocks pushed since beginWriteBatch(), without writing
+           them, so the cache is back to what is in the database */
+        virtual void discardWriteBatch() = 0;
+
         virtual std::vector<uint64_t> getLastUnits(
             size_t count,
             uint32_t blockIndex,
@@ -233,6 +245,15 @@ namespace CryptoNote
         virtual std::vector<uint32_t>
             getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const = 0;
 
+        /* Picks up to count random unlocked key outputs of the amount, and
+           returns their global indexes and keys, sorted by global index */
+        virtual void getRandomKeyOutputsByAmount(
+            uint64_t amount,
+            size_t count,
+            uint32_t blockIndex,
+            std::vector<uint32_t> &globalIndexes,
+            std::vector<Crypto::PublicKey> &publicKeys) const = 0;
+
         virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const = 0;
 
         virtual std::vector<Crypto::Hash>
@@ -0,0 +1,129 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "KeyOutputIndex.h"
+
+#include <algorithm>
+#include <common/ShuffleGenerator.h>
+#include <numeric>
+
+namespace CryptoNote
+{
+    bool KeyOutputIndex::isLoaded(const uint64_t amount) const
+    {
+        std::scoped_lock lock(m_mutex);
+
+        return m_outputs.find(amount) != m_outputs.end();
+    }
+
+    void KeyOutputIndex::load(const uint64_t amount, std::vector<Output> &&outputs)
+    {
+        std::scoped_lock lock(m_mutex);
+
+        m_outputs[amount] = std::move(outputs);
+    }
+
+    void KeyOutputIndex::push(const uint64_t amount, const uint32_t globalIndex, const Output &output)
+    {
+        std::scoped_lock lock(m_mutex);
+
+        const auto it = m_outputs.find(amount);
+
+        if (it == m_outputs.end())
+        {
+            return;
+        }
+
+        /* Out of sync with the database (A block was pushed while the amount
+           was being loaded), drop it so it gets reloaded on next use */
+        if (globalIndex != it->second.size())
+        {
+            m_outputs.erase(it);
+            return;
+        }
+
+        it->second.push_back(output);
+    }
+
+    void KeyOutputIndex::truncate(const uint64_t amount, const uint32_t outputsCount)
+    {
+        std::scoped_lock lock(m_mutex);
+
+        const auto it = m_outputs.find(amount);
+
+        if (it == m_outputs.end())
+        {
+            return;
+        }
+
+        if (outputsCount > it->second.size())
+        {
+            m_outputs.erase(it);
+            return;
+        }
+
+        it->second.resize(outputsCount);
+    }
+
+    bool KeyOutputIndex::pickRandomOutputs(
+        const uint64_t amount,
+        const size_t count,
+        const uint32_t maxBlockIndex,
+        const std::function<bool(uint64_t unlockTime)> &isUnlocked,
+        std::vector<uint32_t> &globalIndexes,
+        std::vector<Crypto::PublicKey> &publicKeys) const
+    {
+        std::scoped_lock lock(m_mutex);
+
+        const auto it = m_outputs.find(amount);
+
+        if (it == m_outputs.end())
+        {
+            return false;
+        }
+
+        const std::vector<Output> &outputs = it->second;
+
+        /* Outputs are stored in block order, so the ones old enough to be
+           spent are all at the start */
+        const auto end = std::upper_bound(
+            outputs.begin(), outputs.end(), maxBlockIndex, [](const uint32_t blockIndex, const Output &output) {
+                return blockIndex < output.blockIndex;
+            });
+
+        ShuffleGenerator<uint32_t> generator(static_cast<uint32_t>(std::distance(outputs.begin(), end)));
+
+        std::vector<uint32_t> picked;
+        picked.reserve(count);
+
+        while (picked.size() < count && !generator.empty())
+        {
+            const uint32_t globalIndex = generator();
+
+            if (isUnlocked(outputs[globalIndex].unlockTime))
+            {
+                picked.push_back(globalIndex);
+            }
+        }
+
+        std::sort(picked.begin(), picked.end());
+
+        for (const auto globalIndex : picked)
+        {
+            globalIndexes.push_back(globalIndex);
+            publicKeys.push_back(outputs[globalIndex].publicKey);
+        }
+
+        return true;
+    }
+
+    size_t KeyOutputIndex::size() const
+    {
+        std::scoped_lock lock(m_mutex);
+
+        return std::accumulate(m_outputs.begin(), m_outputs.end(), size_t(0), [](const size_t total, const auto &kv) {
+            return total + kv.second.size();
+        });
+    }
+} // namespace CryptoNote
@@ -0,0 +1,65 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoTypes.h>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace CryptoNote
+{
+    /* In memory index of the key outputs of each amount, so picking random
+       outputs for /getrandom_outs doesn't need several database round trips
+       per amount. Amounts are loaded on first use, and kept up to date as
+       blocks are pushed and removed. */
+    class KeyOutputIndex
+    {
+      public:
+        struct Output
+        {
+            Crypto::PublicKey publicKey;
+
+            /* Index of the block the output was created in */
+            uint32_t blockIndex;
+
+            /* Unlock time of the transaction the output was created in */
+            uint64_t unlockTime;
+        };
+
+        bool isLoaded(const uint64_t amount) const;
+
+        /* Sets every output of the amount, in global index order */
+        void load(const uint64_t amount, std::vector<Output> &&outputs);
+
+        /* Appends an output. Does nothing if the amount isn't loaded. */
+        void push(const uint64_t amount, const uint32_t globalIndex, const Output &output);
+
+        /* Removes the outputs with a global index of outputsCount or above */
+        void truncate(const uint64_t amount, const uint32_t outputsCount);
+
+        /* Picks up to count random outputs created at or before
+           maxBlockIndex which isUnlocked accepts the unlock time of. The
+           results are sorted by global index. Returns false if the amount
+           isn't loaded. */
+        bool pickRandomOutputs(
+            const uint64_t amount,
+            const size_t count,
+            const uint32_t maxBlockIndex,
+            const std::function<bool(uint64_t unlockTime)> &isUnlocked,
+            std::vector<uint32_t> &globalIndexes,
+            std::vector<Crypto::PublicKey> &publicKeys) const;
+
+        /* Total amount of outputs held in memory */
+        size_t size() const;
+
+      private:
+        /* Amount to outputs, indexed by global output index */
+        std::unordered_map<uint64_t, std::vector<Output>> m_outputs;
+
+        mutable std::mutex m_mutex;
+    };
+} // namespace CryptoNote
@@ -17,7 +17,7 @@ ValidateTransaction::ValidateTransaction(
     CryptoNote::IBlockchainCache *cache,
     const CryptoNote::Currency &currency,
     const CryptoNote::Checkpoints &checkpoints,
-    Utilities::ThreadPool<bool> &threadPool,
+    Utilities::WorkStealingThreadPool &threadPool,
     const uint64_t blockHeight,
     const uint64_t blockSizeMedian,
     const bool isPoolTransaction) :
@@ -35,6 +35,24 @@ ValidateTransaction::ValidateTransaction(
 }
 
 TransactionValidationResult ValidateTransaction::validate()
+{
+    /* Perform the cheaper checks first, so we fail fast before getting to
+     * the expensive ones */
+    if (!validateWithoutExpensiveChecks().valid)
+    {
+        return m_validationResult;
+    }
+
+    /* Verify key images are not spent, ring signatures are valid, etc. We
+     * do this separately from the transaction input verification, because
+     * these checks are much slower to perform, so we want to fail fast on the
+     * cheaper checks first. */
+    validateTransactionInputsExpensive();
+
+    return m_validationResult;
+}
+
+TransactionValidationResult ValidateTransaction::validateWithoutExpensiveChecks()
 {
     /* Validate transaction isn't too big */
     if (!validateTransactionSize())
@@ -78,15 +96,6 @@ TransactionValidationResult ValidateTransaction::validate()
         return m_validationResult;
     }
 
-    /* Verify key images are not spent, ring signatures are valid, etc. We
-     * do this separately from the transaction input verification, because
-     * these checks are much slower to perform, so we want to fail fast on the
-     * cheaper checks first. */
-    if (!validateTransactionInputsExpensive())
-    {
-        return m_validationResult;
-    }
-
     m_validationResult.valid = true;
     setTransactionValidationResult(
         CryptoNote::error::TransactionValidationError::VALIDATION_SUCCESS
@@ -124,6 +133,12 @@ TransactionValidationResult ValidateTransaction::revalidateAfterHeightChange()
     return m_validationResult;
 }
 
+TransactionValidationResult ValidateTransaction::getValidationResult()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    return m_validationResult;
+}
 
 bool ValidateTransaction::validateTransactionSize()
 {
@@ -476,124 +491,110 @@ bool ValidateTransaction::validateTransactionMixin()
 }
 
 bool ValidateTransaction::validateTransactionInputsExpensive()
+{
+    BlockSignatureVerifier verifier(m_threadPool);
+
+    verifier.addTransaction(*this);
+
+    return !verifier.verify();
+}
+
+bool ValidateTransaction::requiresExpensiveChecks() const
 {
     /* Don't need to do expensive transaction validation for transactions
      * in a checkpoints range - they are assumed valid, and the transaction
      * hash would change thus invalidation the checkpoints if not. */
-    if (m_checkpoints.isInCheckpointZone(m_blockHeight + 1))
-    {
-        return true;
-    }
-
-    uint64_t inputIndex = 0;
+    return !m_checkpoints.isInCheckpointZone(m_blockHeight + 1);
+}
 
-    std::vector<std::future<bool>> validationResult;
-    std::atomic<bool> cancelValidation = false;
-    const Crypto::Hash prefixHash = m_cachedTransaction.getTransactionPrefixHash();
+bool ValidateTransaction::validateTransactionInputExpensive(
+    const size_t inputIndex,
+    const Crypto::Hash &prefixHash,
+    std::vector<uint32_t> &globalIndexes,
+    std::vector<Crypto::PublicKey> &outputKeys)
+{
+    const CryptoNote::KeyInput &in = boost::get<CryptoNote::KeyInput>(m_transaction.inputs[inputIndex]);
 
-    for (const auto &input : m_transaction.inputs)
+    if (m_blockchainCache->checkIfSpent(in.keyImage, m_blockHeight))
     {
-        /* Validate each input on a separate thread in our thread pool */
-        validationResult.push_back(m_threadPool.addJob([inputIndex, &input, &prefixHash, &cancelValidation, this] {
-            const CryptoNote::KeyInput &in = boost::get<CryptoNote::KeyInput>(input);
-            if (cancelValidation)
-            {
-                return false; // fail the validation immediately if cancel requested
-            }
-            if (m_blockchainCache->checkIfSpent(in.keyImage, m_blockHeight))
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_KEYIMAGE_ALREADY_SPENT,
-                    "Transaction contains key image that has already been spent"
-                );
-
-                return false;
-            }
-
-            std::vector<Crypto::PublicKey> outputKeys;
-            std::vector<uint32_t> globalIndexes(in.outputIndexes.size());
-
-            globalIndexes[0] = in.outputIndexes[0];
-
-            /* Convert output indexes from relative to absolute */
-            for (size_t i = 1; i < in.outputIndexes.size(); ++i)
-            {
-                globalIndexes[i] = globalIndexes[i - 1] + in.outputIndexes[i];
-            }
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_KEYIMAGE_ALREADY_SPENT,
+            "Transaction contains key image that has already been spent"
+        );
 
-            const auto result = m_blockchainCache->extractKeyOutputKeys(
-                in.amount, m_blockHeight, {globalIndexes.data(), globalIndexes.size()}, outputKeys);
+        return false;
+    }
 
-            if (result == CryptoNote::ExtractOutputKeysResult::INVALID_GLOBAL_INDEX)
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_INVALID_GLOBAL_INDEX,
-                    "Transaction contains invalid global indexes"
-                );
+    outputKeys.clear();
+    globalIndexes.resize(in.outputIndexes.size());
 
-                return false;
-            }
+    globalIndexes[0] = in.outputIndexes[0];
 
-            if (result == CryptoNote::ExtractOutputKeysResult::OUTPUT_LOCKED)
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_SPEND_LOCKED_OUT,
-                    "Transaction includes an input which is still locked"
-                );
-
-                return false;
-            }
+    /* Convert output indexes from relative to absolute */
+    for (size_t i = 1; i < in.outputIndexes.size(); ++i)
+    {
+        globalIndexes[i] = globalIndexes[i - 1] + in.outputIndexes[i];
+    }
 
-            if (m_isPoolTransaction
-                || m_blockHeight >= CryptoNote::parameters::TRANSACTION_SIGNATURE_COUNT_VALIDATION_HEIGHT)
-            {
-                if (outputKeys.size() != m_transaction.signatures[inputIndex].size())
-                {
-                    setTransactionValidationResult(
-                        CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES_COUNT,
-                        "Transaction has an invalid number of signatures"
-                    );
-
-                    return false;
-                }
-            }
+    const auto result = m_blockchainCache->extractKeyOutputKeys(
+        in.amount, m_blockHeight, {globalIndexes.data(), globalIndexes.size()}, outputKeys);
 
-            if (!Crypto::crypto_ops::checkRingSignature(
-                    prefixHash, in.keyImage, outputKeys, m_transaction.signatures[inputIndex]))
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES,
-                    "Transaction contains invalid signatures"
-                );
+    if (result == CryptoNote::ExtractOutputKeysResult::INVALID_GLOBAL_INDEX)
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_INVALID_GLOBAL_INDEX,
+            "Transaction contains invalid global indexes"
+        );
 
-                return false;
-            }
+        return false;
+    }
 
-            return true;
-        }));
+    if (result == CryptoNote::ExtractOutputKeysResult::OUTPUT_LOCKED)
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_SPEND_LOCKED_OUT,
+            "Transaction includes an input which is still locked"
+        );
 
-        inputIndex++;
+        return false;
     }
 
-    bool valid = true;
-
-    for (auto &result : validationResult)
+    if (m_isPoolTransaction
+        || m_blockHeight >= CryptoNote::parameters::TRANSACTION_SIGNATURE_COUNT_VALIDATION_HEIGHT)
     {
-        if (!result.get())
+        if (outputKeys.size() != m_transaction.signatures[inputIndex].size())
         {
-            valid = false;
-            cancelValidation = true;
+            setTransactionValidationResult(
+                CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES_COUNT,
+                "Transaction has an invalid number of signatures"
+            );
+
+            return false;
         }
     }
 
-    return valid;
-}
+    if (!Crypto::crypto_ops::checkRingSignature(
+            prefixHash, in.keyImage, outputKeys, m_transaction.signatures[inputIndex]))
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES,
+            "Transaction contains invalid signatures"
+        );
 
+        return false;
+    }
+
+    return true;
+}
 
 void ValidateTransaction::setTransactionValidationResult(const std::error_code &error_code, const std::string &error_message)
 {
     std::scoped_lock<std::mutex> lock(m_mutex);
 
+    /* Inputs are checked after the result has been marked valid when
+     * validating a block, so make sure a failure there unsets it */
+    m_validationResult.valid = !error_code;
+
     m_validationResult.errorCode = error_code;
 
     m_validationResult.errorMessage = error_message;
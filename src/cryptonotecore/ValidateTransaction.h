@@ -10,11 +10,12 @@
 #include <system_error>
 
 #include <CryptoNote.h>
+#include <cryptonotecore/BlockSignatureVerifier.h>
 #include <cryptonotecore/CachedTransaction.h>
 #include <cryptonotecore/Checkpoints.h>
 #include <cryptonotecore/Currency.h>
 #include <cryptonotecore/IBlockchainCache.h>
-#include <utilities/ThreadPool.h>
+#include <utilities/WorkStealingThreadPool.h>
 
 struct TransactionValidationResult
 {
@@ -46,7 +47,7 @@ class ValidateTransaction
             CryptoNote::IBlockchainCache *cache,
             const CryptoNote::Currency &currency,
             const CryptoNote::Checkpoints &checkpoints,
-            Utilities::ThreadPool<bool> &threadPool,
+            Utilities::WorkStealingThreadPool &threadPool,
             const uint64_t blockHeight,
             const uint64_t blockSizeMedian,
             const bool isPoolTransaction);
@@ -56,9 +57,19 @@ class ValidateTransaction
         /////////////////////////////
         TransactionValidationResult validate();
 
+        /* Performs every check apart from the expensive input checks. Used
+         * when validating a block - the caller adds the transaction to a
+         * BlockSignatureVerifier, so the inputs of every transaction in the
+         * block are checked as one batch. */
+        TransactionValidationResult validateWithoutExpensiveChecks();
+
         TransactionValidationResult revalidateAfterHeightChange();
 
+        TransactionValidationResult getValidationResult();
+
     private:
+        friend class BlockSignatureVerifier;
+
         //////////////////////////////
         /* PRIVATE MEMBER FUNCTIONS */
         //////////////////////////////
@@ -78,6 +89,16 @@ class ValidateTransaction
 
         bool validateTransactionInputsExpensive();
 
+        bool requiresExpensiveChecks() const;
+
+        /* Checks a single input. globalIndexes and outputKeys are scratch
+         * space, passed in so they can be reused between inputs. */
+        bool validateTransactionInputExpensive(
+            const size_t inputIndex,
+            const Crypto::Hash &prefixHash,
+            std::vector<uint32_t> &globalIndexes,
+            std::vector<Crypto::PublicKey> &outputKeys);
+
         void setTransactionValidationResult(const std::error_code &error_code, const std::string &error_message = "");
 
         /////////////////////////
@@ -106,7 +127,7 @@ class ValidateTransaction
         uint64_t m_sumOfOutputs = 0;
         uint64_t m_sumOfInputs = 0;
 
-        Utilities::ThreadPool<bool> &m_threadPool;
+        Utilities::WorkStealingThreadPool &m_threadPool;
 
         std::mutex m_mutex;
 };
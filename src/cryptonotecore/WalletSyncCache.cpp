@@ -0,0 +1,123 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "WalletSyncCache.h"
+
+namespace CryptoNote
+{
+    WalletSyncCache::WalletSyncCache(const size_t maxSize): m_maxSize(maxSize) {}
+
+    template<typename Predicate> void WalletSyncCache::removeIf(const Predicate predicate)
+    {
+        for (auto it = m_lru.begin(); it != m_lru.end();)
+        {
+            if (predicate(*it->second))
+            {
+                m_size -= it->second->data.size();
+                m_entries.erase(it->first);
+                it = m_lru.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    std::shared_ptr<const WalletSyncCache::Chunk>
+        WalletSyncCache::get(const uint64_t startIndex, const uint64_t blockCount, const bool skipCoinbase)
+    {
+        std::scoped_lock lock(m_mutex);
+
+        const auto it = m_entries.find({startIndex, blockCount, skipCoinbase});
+
+        if (it == m_entries.end())
+        {
+            m_misses++;
+            return nullptr;
+        }
+
+        m_hits++;
+
+        /* Move to the front of the LRU */
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+
+        return it->second->second;
+    }
+
+    void WalletSyncCache::insert(
+        const uint64_t startIndex,
+        const uint64_t blockCount,
+        const bool skipCoinbase,
+        const std::shared_ptr<const Chunk> chunk,
+        const uint64_t generation)
+    {
+        /* Don't let one chunk flush the whole cache */
+        if (chunk->data.size() > m_maxSize / 4)
+        {
+            return;
+        }
+
+        std::scoped_lock lock(m_mutex);
+
+        if (generation != m_generation)
+        {
+            return;
+        }
+
+        const Key key {startIndex, blockCount, skipCoinbase};
+
+        /* Another thread got here first */
+        if (m_entries.find(key) != m_entries.end())
+        {
+            return;
+        }
+
+        m_lru.emplace_front(key, chunk);
+        m_entries[key] = m_lru.begin();
+        m_size += chunk->data.size();
+
+        while (m_size > m_maxSize && !m_lru.empty())
+        {
+            const auto &[oldestKey, oldestChunk] = m_lru.back();
+
+            m_size -= oldestChunk->data.size();
+            m_entries.erase(oldestKey);
+            m_lru.pop_back();
+        }
+    }
+
+    uint64_t WalletSyncCache::getGeneration() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_generation;
+    }
+
+    void WalletSyncCache::onNewBlock()
+    {
+        std::scoped_lock lock(m_mutex);
+
+        m_generation++;
+
+        removeIf([](const Chunk &chunk) { return chunk.reachedTop; });
+    }
+
+    void WalletSyncCache::onChainSwitch(const uint64_t splitIndex)
+    {
+        std::scoped_lock lock(m_mutex);
+
+        m_generation++;
+
+        /* Chunks which reached the top covered every block up to it, the
+           others covered up to their last block */
+        removeIf([splitIndex](const Chunk &chunk) {
+            return chunk.reachedTop || chunk.lastBlockHeight >= splitIndex;
+        });
+    }
+
+    std::tuple<uint64_t, uint64_t> WalletSyncCache::getStatistics() const
+    {
+        return {m_hits.load(), m_misses.load()};
+    }
+} // namespace CryptoNote
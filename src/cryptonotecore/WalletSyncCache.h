@@ -0,0 +1,118 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoTypes.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace CryptoNote
+{
+    /* Caches the blocks returned by /getwalletsyncdata, already encoded in
+       the WalletSyncStream format, so we don't have to reparse the same raw
+       blocks for every wallet asking for the same range. */
+    class WalletSyncCache
+    {
+      public:
+        struct Chunk
+        {
+            /* The blocks, encoded with WalletSyncStream::encodeBlocks() */
+            std::string data;
+
+            /* Amount of blocks in data */
+            uint64_t blockCount = 0;
+
+            /* Height and hash of the last block in data. Only valid if
+               blockCount is not zero */
+            uint64_t lastBlockHeight = 0;
+
+            Crypto::Hash lastBlockHash;
+
+            /* Whether the chunk was cut short by the top of the chain, and
+               so will grow as new blocks arrive */
+            bool reachedTop = false;
+        };
+
+        explicit WalletSyncCache(const size_t maxSize);
+
+        /* Returns nullptr if the chunk is not cached */
+        std::shared_ptr<const Chunk> get(const uint64_t startIndex, const uint64_t blockCount, const bool skipCoinbase);
+
+        /* Stores the chunk, unless the cache has been invalidated since
+           generation was read with getGeneration(), in which case the chunk
+           may be built from blocks which are no longer in the main chain */
+        void insert(
+            const uint64_t startIndex,
+            const uint64_t blockCount,
+            const bool skipCoinbase,
+            const std::shared_ptr<const Chunk> chunk,
+            const uint64_t generation);
+
+        uint64_t getGeneration() const;
+
+        /* A block was added to the top of the main chain */
+        void onNewBlock();
+
+        /* The main chain switched, blocks from splitIndex onwards changed */
+        void onChainSwitch(const uint64_t splitIndex);
+
+        /* {hits, misses} */
+        std::tuple<uint64_t, uint64_t> getStatistics() const;
+
+      private:
+        struct Key
+        {
+            uint64_t startIndex;
+
+            uint64_t blockCount;
+
+            bool skipCoinbase;
+
+            bool operator==(const Key &other) const
+            {
+                return startIndex == other.startIndex && blockCount == other.blockCount
+                       && skipCoinbase == other.skipCoinbase;
+            }
+        };
+
+        struct KeyHasher
+        {
+            size_t operator()(const Key &key) const
+            {
+                return std::hash<uint64_t>()(key.startIndex) ^ (std::hash<uint64_t>()(key.blockCount) << 1)
+                       ^ static_cast<size_t>(key.skipCoinbase);
+            }
+        };
+
+        typedef std::list<std::pair<Key, std::shared_ptr<const Chunk>>> LruList;
+
+        /* Removes entries matching the predicate. Must hold m_mutex. */
+        template<typename Predicate> void removeIf(const Predicate predicate);
+
+        /* Most recently used at the front */
+        LruList m_lru;
+
+        std::unordered_map<Key, LruList::iterator, KeyHasher> m_entries;
+
+        /* Total size of the cached chunk data */
+        size_t m_size = 0;
+
+        const size_t m_maxSize;
+
+        /* Incremented whenever cached data is invalidated */
+        uint64_t m_generation = 0;
+
+        std::atomic<uint64_t> m_hits = 0;
+
+        std::atomic<uint64_t> m_misses = 0;
+
+        mutable std::mutex m_mutex;
+    };
+} // namespace CryptoNote
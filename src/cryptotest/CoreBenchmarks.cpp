@@ -0,0 +1,611 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "CoreBenchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <common/ShuffleGenerator.h>
+#include <crypto/hash.h>
+#include <crypto/random.h>
+#include <cryptonotecore/BlockSignatureVerifier.h>
+#include <cryptonotecore/BlockchainCache.h>
+#include <cryptonotecore/BlockchainReadBatch.h>
+#include <cryptonotecore/BlockchainWriteBatch.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/Checkpoints.h>
+#include <cryptonotecore/Currency.h>
+#include <cryptonotecore/DataBaseConfig.h>
+#include <cryptonotecore/KeyOutputIndex.h>
+#include <cryptonotecore/ValidateTransaction.h>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <logging/DummyLogger.h>
+#include <set>
+#include <utilities/ThreadPool.h>
+#include <utilities/WorkStealingThreadPool.h>
+
+#if defined(USE_LEVELDB)
+#include <cryptonotecore/LevelDBWrapper.h>
+#else
+#include <cryptonotecore/RocksDBWrapper.h>
+#endif
+
+using namespace CryptoNote;
+
+namespace
+{
+    const uint64_t AMOUNT = 100;
+
+    /* Roughly a busy chain - 2,000 blocks of 50 transactions with 4 outputs
+       of the amount each */
+    const uint32_t BLOCK_COUNT = 2000;
+    const uint32_t TRANSACTIONS_PER_BLOCK = 50;
+    const uint32_t OUTPUTS_PER_TRANSACTION = 4;
+
+    /* Outputs requested per /getrandom_outs amount */
+    const size_t OUTPUTS_TO_PICK = 8;
+
+    const uint64_t LOOP_ITERATIONS = 2000;
+
+    /* Leaves room for the mined money unlock window */
+    const uint32_t MAX_BLOCK_INDEX = BLOCK_COUNT - 100;
+
+    /* Not a denomination the genesis block pays out, so the funding
+       outputs are the only ones of the amount */
+    const uint64_t FUSION_INPUT_AMOUNT = 1234567;
+
+    /* Fusion transactions are as large as transactions get - lots of inputs
+       being combined into a few outputs */
+    const size_t FUSION_TRANSACTIONS_PER_BLOCK = 20;
+    const size_t FUSION_TRANSACTION_INPUTS = 40;
+    const size_t RING_SIZE = 4;
+
+    const uint64_t BLOCK_ITERATIONS = 5;
+
+    /* Roughly the cost of the smaller jobs the pools run */
+    const size_t THREAD_POOL_JOBS = 200000;
+    const size_t THREAD_POOL_JOB_HASHES = 4;
+
+    template<typename T> T randomPod()
+    {
+        T result;
+
+        for (size_t i = 0; i < sizeof(result); i++)
+        {
+            reinterpret_cast<uint8_t *>(&result)[i] = Random::randomValue<uint8_t>();
+        }
+
+        return result;
+    }
+
+    BlockchainReadResult read(IDataBase &database, BlockchainReadBatch &batch)
+    {
+        if (database.read(batch))
+        {
+            throw std::runtime_error("Failed to read database");
+        }
+
+        return batch.extractResult();
+    }
+
+    void populateDatabase(IDataBase &database)
+    {
+        uint32_t globalIndex = 0;
+        uint64_t transactionCount = 0;
+
+        for (uint32_t blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+        {
+            BlockchainWriteBatch batch;
+
+            std::vector<Crypto::Hash> transactionHashes;
+            std::vector<PackedOutIndex> packedOutputs;
+
+            for (uint16_t transactionIndex = 0; transactionIndex < TRANSACTIONS_PER_BLOCK; transactionIndex++)
+            {
+                ExtendedTransactionInfo transaction;
+                transaction.blockIndex = blockIndex;
+                transaction.transactionIndex = transactionIndex;
+                transaction.transactionHash = randomPod<Crypto::Hash>();
+                transaction.unlockTime = 0;
+
+                for (uint16_t outputIndex = 0; outputIndex < OUTPUTS_PER_TRANSACTION; outputIndex++)
+                {
+                    KeyOutput output;
+                    output.key = randomPod<Crypto::PublicKey>();
+
+                    transaction.outputs.push_back(output);
+                    transaction.globalIndexes.push_back(globalIndex);
+                    transaction.amountToKeyIndexes[AMOUNT].push_back(globalIndex);
+
+                    PackedOutIndex packedOutput;
+                    packedOutput.blockIndex = blockIndex;
+                    packedOutput.transactionIndex = transactionIndex;
+                    packedOutput.outputIndex = outputIndex;
+                    packedOutputs.push_back(packedOutput);
+
+                    KeyOutputInfo outputInfo;
+                    outputInfo.publicKey = output.key;
+                    outputInfo.transactionHash = transaction.transactionHash;
+                    outputInfo.unlockTime = transaction.unlockTime;
+                    outputInfo.outputIndex = outputIndex;
+
+                    batch.insertKeyOutputInfo(AMOUNT, globalIndex, outputInfo);
+
+                    globalIndex++;
+                }
+
+                transactionHashes.push_back(transaction.transactionHash);
+
+                batch.insertCachedTransaction(transaction, ++transactionCount);
+            }
+
+            CachedBlockInfo blockInfo;
+            blockInfo.blockHash = randomPod<Crypto::Hash>();
+
+            batch.insertCachedBlock(blockInfo, blockIndex, transactionHashes);
+            batch.insertKeyOutputGlobalIndexes(AMOUNT, packedOutputs, globalIndex);
+
+            if (database.write(batch))
+            {
+                throw std::runtime_error("Failed to write database");
+            }
+        }
+    }
+
+    /* What DatabaseBlockchainCache::getRandomOutsByAmount() followed by
+       extractKeyOutputKeys() did */
+    void pickFromDatabase(IDataBase &database)
+    {
+        auto countBatch = BlockchainReadBatch().requestKeyOutputGlobalIndexesCountForAmount(AMOUNT);
+        const uint32_t outputsCount = read(database, countBatch).getKeyOutputGlobalIndexesCountForAmounts().at(AMOUNT);
+
+        ShuffleGenerator<uint32_t> generator(outputsCount);
+
+        std::vector<uint32_t> globalIndexes;
+
+        for (size_t i = 0; i < OUTPUTS_TO_PICK; i++)
+        {
+            globalIndexes.push_back(generator());
+        }
+
+        BlockchainReadBatch packedBatch;
+
+        for (const auto globalIndex : globalIndexes)
+        {
+            packedBatch.requestKeyOutputGlobalIndexForAmount(AMOUNT, globalIndex);
+        }
+
+        const auto packedResult = read(database, packedBatch);
+
+        std::set<uint32_t> blockIndexes;
+
+        for (const auto globalIndex : globalIndexes)
+        {
+            blockIndexes.insert(packedResult.getKeyOutputGlobalIndexesForAmounts().at({AMOUNT, globalIndex}).blockIndex);
+        }
+
+        BlockchainReadBatch hashesBatch;
+
+        for (const auto blockIndex : blockIndexes)
+        {
+            hashesBatch.requestTransactionHashesByBlock(blockIndex);
+        }
+
+        const auto hashesResult = read(database, hashesBatch);
+
+        BlockchainReadBatch transactionsBatch;
+
+        for (const auto globalIndex : globalIndexes)
+        {
+            const auto packed = packedResult.getKeyOutputGlobalIndexesForAmounts().at({AMOUNT, globalIndex});
+
+            transactionsBatch.requestCachedTransaction(
+                hashesResult.getTransactionHashesByBlocks().at(packed.blockIndex).at(packed.transactionIndex));
+        }
+
+        read(database, transactionsBatch);
+
+        std::vector<uint32_t> unlocked;
+
+        for (const auto globalIndex : globalIndexes)
+        {
+            const auto packed = packedResult.getKeyOutputGlobalIndexesForAmounts().at({AMOUNT, globalIndex});
+
+            if (packed.blockIndex <= MAX_BLOCK_INDEX)
+            {
+                unlocked.push_back(globalIndex);
+            }
+        }
+
+        std::sort(unlocked.begin(), unlocked.end());
+
+        BlockchainReadBatch keysBatch;
+
+        for (const auto globalIndex : unlocked)
+        {
+            keysBatch.requestKeyOutputInfo(AMOUNT, globalIndex);
+        }
+
+        read(database, keysBatch);
+    }
+
+    void loadIndex(IDataBase &database, KeyOutputIndex &index)
+    {
+        const uint32_t outputsCount = BLOCK_COUNT * TRANSACTIONS_PER_BLOCK * OUTPUTS_PER_TRANSACTION;
+
+        BlockchainReadBatch batch;
+
+        for (uint32_t globalIndex = 0; globalIndex < outputsCount; globalIndex++)
+        {
+            batch.requestKeyOutputGlobalIndexForAmount(AMOUNT, globalIndex);
+            batch.requestKeyOutputInfo(AMOUNT, globalIndex);
+        }
+
+        const auto result = read(database, batch);
+
+        std::vector<KeyOutputIndex::Output> outputs;
+
+        for (uint32_t globalIndex = 0; globalIndex < outputsCount; globalIndex++)
+        {
+            const auto &info = result.getKeyOutputInfo().at({AMOUNT, globalIndex});
+            const auto &packed = result.getKeyOutputGlobalIndexesForAmounts().at({AMOUNT, globalIndex});
+
+            outputs.push_back({info.publicKey, packed.blockIndex, info.unlockTime});
+        }
+
+        index.load(AMOUNT, std::move(outputs));
+    }
+
+    /* Pushes a block to the cache with a transaction creating every output
+       the fusion transactions will spend, and returns the keys to spend them */
+    std::vector<Crypto::SecretKey> pushFundingBlock(BlockchainCache &cache, const size_t outputCount)
+    {
+        std::vector<Crypto::SecretKey> secretKeys;
+
+        Transaction funding;
+        funding.version = CURRENT_TRANSACTION_VERSION;
+        funding.unlockTime = 0;
+
+        for (size_t i = 0; i < outputCount; i++)
+        {
+            KeyOutput output;
+            Crypto::SecretKey secretKey;
+
+            Crypto::generate_keys(output.key, secretKey);
+
+            funding.outputs.push_back({FUSION_INPUT_AMOUNT, output});
+            secretKeys.push_back(secretKey);
+        }
+
+        BlockTemplate block;
+        block.majorVersion = BLOCK_MAJOR_VERSION_1;
+        block.minorVersion = BLOCK_MINOR_VERSION_0;
+        block.nonce = 0;
+        block.timestamp = 0;
+        block.previousBlockHash = cache.getTopBlockHash();
+        block.baseTransaction.version = CURRENT_TRANSACTION_VERSION;
+        block.baseTransaction.unlockTime = 0;
+        block.baseTransaction.inputs.push_back(BaseInput {1});
+
+        const CachedBlock cachedBlock(block);
+
+        cache.pushBlock(cachedBlock, {CachedTransaction(std::move(funding))}, {}, 1, 0, 1, RawBlock());
+
+        return secretKeys;
+    }
+
+    std::vector<CachedTransaction> createFusionTransactions(const std::vector<Crypto::SecretKey> &secretKeys)
+    {
+        std::vector<CachedTransaction> transactions;
+
+        uint32_t nextOutput = 0;
+
+        for (size_t i = 0; i < FUSION_TRANSACTIONS_PER_BLOCK; i++)
+        {
+            Transaction transaction;
+            transaction.version = CURRENT_TRANSACTION_VERSION;
+            transaction.unlockTime = 0;
+
+            /* The keys of each ring in global index order, which of them is
+               the real one, and the key to sign with */
+            std::vector<std::tuple<std::vector<Crypto::PublicKey>, size_t, Crypto::SecretKey>> rings;
+
+            for (size_t j = 0; j < FUSION_TRANSACTION_INPUTS; j++)
+            {
+                const uint32_t realOutput = nextOutput++;
+
+                std::set<uint32_t> ring = {realOutput};
+
+                while (ring.size() < RING_SIZE)
+                {
+                    ring.insert(Random::randomValue<uint32_t>(0, static_cast<uint32_t>(secretKeys.size()) - 1));
+                }
+
+                KeyInput input;
+                input.amount = FUSION_INPUT_AMOUNT;
+
+                std::vector<Crypto::PublicKey> ringKeys;
+                uint32_t previous = 0;
+
+                for (const auto globalIndex : ring)
+                {
+                    input.outputIndexes.push_back(globalIndex - previous);
+                    previous = globalIndex;
+
+                    Crypto::PublicKey publicKey;
+                    Crypto::secret_key_to_public_key(secretKeys[globalIndex], publicKey);
+                    ringKeys.push_back(publicKey);
+                }
+
+                const size_t realIndex = std::distance(ring.begin(), ring.find(realOutput));
+
+                Crypto::generate_key_image(ringKeys[realIndex], secretKeys[realOutput], input.keyImage);
+
+                rings.emplace_back(ringKeys, realIndex, secretKeys[realOutput]);
+
+                transaction.inputs.push_back(input);
+            }
+
+            KeyOutput output;
+            Crypto::SecretKey ignored;
+            Crypto::generate_keys(output.key, ignored);
+
+            /* Leave a small fee */
+            transaction.outputs.push_back({FUSION_INPUT_AMOUNT * FUSION_TRANSACTION_INPUTS - 10, output});
+
+            const Crypto::Hash prefixHash = CachedTransaction(transaction).getTransactionPrefixHash();
+
+            for (size_t j = 0; j < transaction.inputs.size(); j++)
+            {
+                const auto &[ringKeys, realIndex, secretKey] = rings[j];
+
+                const auto [success, signatures] = Crypto::crypto_ops::generateRingSignatures(
+                    prefixHash, boost::get<KeyInput>(transaction.inputs[j]).keyImage, ringKeys, secretKey, realIndex);
+
+                if (!success)
+                {
+                    throw std::runtime_error("Failed to generate ring signatures");
+                }
+
+                transaction.signatures.push_back(signatures);
+            }
+
+            transactions.emplace_back(std::move(transaction));
+        }
+
+        return transactions;
+    }
+} // namespace
+
+void benchmarkThreadPools()
+{
+    std::vector<Crypto::Hash> hashes(THREAD_POOL_JOBS);
+
+    const auto job = [&hashes](const size_t i) {
+        Crypto::Hash hash = {};
+
+        for (size_t j = 0; j < THREAD_POOL_JOB_HASHES; j++)
+        {
+            hash = Crypto::cn_fast_hash(&hash, sizeof(hash));
+        }
+
+        hashes[i] = hash;
+    };
+
+    const auto jobsPerSecond = [](const auto function) {
+        const auto startTimer = std::chrono::high_resolution_clock::now();
+
+        function();
+
+        const auto elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+        return static_cast<uint64_t>(
+            THREAD_POOL_JOBS / (std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / 1000000.0));
+    };
+
+    uint64_t threadCount = 0;
+    uint64_t futureJobsPerSecond = 0;
+    uint64_t submitJobsPerSecond = 0;
+    uint64_t bulkJobsPerSecond = 0;
+
+    {
+        Utilities::ThreadPool<bool> threadPool;
+
+        futureJobsPerSecond = jobsPerSecond([&] {
+            std::vector<std::future<bool>> results;
+
+            for (size_t i = 0; i < THREAD_POOL_JOBS; i++)
+            {
+                results.push_back(threadPool.addJob([i, &job] {
+                    job(i);
+                    return true;
+                }));
+            }
+
+            for (auto &result : results)
+            {
+                result.get();
+            }
+        });
+    }
+
+    {
+        Utilities::WorkStealingThreadPool threadPool;
+
+        threadCount = threadPool.threadCount();
+
+        submitJobsPerSecond = jobsPerSecond([&] {
+            Utilities::WaitGroup waitGroup;
+
+            for (size_t i = 0; i < THREAD_POOL_JOBS; i++)
+            {
+                threadPool.submit(waitGroup, [i, &job] {
+                    job(i);
+                });
+            }
+
+            threadPool.wait(waitGroup);
+        });
+
+        bulkJobsPerSecond = jobsPerSecond([&] {
+            Utilities::WaitGroup waitGroup;
+
+            threadPool.submitBulk(waitGroup, THREAD_POOL_JOBS, job);
+
+            threadPool.wait(waitGroup);
+        });
+    }
+
+    std::cout << "Thread pools (" << threadCount << " threads)" << std::endl;
+    std::cout << "ThreadPool::addJob(): " << futureJobsPerSecond << " jobs/s" << std::endl;
+    std::cout << "WorkStealingThreadPool::submit(): " << submitJobsPerSecond << " jobs/s" << std::endl;
+    std::cout << "WorkStealingThreadPool::submitBulk(): " << bulkJobsPerSecond << " jobs/s" << std::endl;
+}
+
+void benchmarkBlockSignatures()
+{
+    const auto logger = std::make_shared<Logging::DummyLogger>();
+
+    const Currency currency = CurrencyBuilder(logger).currency();
+    const Checkpoints checkpoints(logger);
+
+    BlockchainCache cache("", currency, logger, nullptr);
+
+    const auto secretKeys = pushFundingBlock(cache, FUSION_TRANSACTIONS_PER_BLOCK * FUSION_TRANSACTION_INPUTS);
+    const auto transactions = createFusionTransactions(secretKeys);
+
+    const uint32_t blockIndex = cache.getTopBlockIndex();
+
+    /* Large enough the fusion transactions aren't rejected for their size */
+    const uint64_t blockSizeMedian = 1000000;
+
+    Utilities::WorkStealingThreadPool threadPool;
+
+    /* Each transaction fully validated before moving on to the next */
+    const auto validateTransactionAtATime = [&] {
+        TransactionValidatorState state;
+
+        for (const auto &transaction : transactions)
+        {
+            ValidateTransaction validator(
+                transaction, state, &cache, currency, checkpoints, threadPool, blockIndex, blockSizeMedian, false);
+
+            if (!validator.validate().valid)
+            {
+                throw std::runtime_error("Fusion transaction failed to validate");
+            }
+        }
+    };
+
+    /* The cheap checks of each transaction, then every input in one batch */
+    const auto validateBlockAtOnce = [&] {
+        TransactionValidatorState state;
+        std::deque<ValidateTransaction> validators;
+        BlockSignatureVerifier verifier(threadPool);
+
+        for (const auto &transaction : transactions)
+        {
+            auto &validator = validators.emplace_back(
+                transaction, state, &cache, currency, checkpoints, threadPool, blockIndex, blockSizeMedian, false);
+
+            if (!validator.validateWithoutExpensiveChecks().valid)
+            {
+                throw std::runtime_error("Fusion transaction failed to validate");
+            }
+
+            verifier.addTransaction(validator);
+        }
+
+        if (verifier.verify())
+        {
+            throw std::runtime_error("Fusion transaction failed to validate");
+        }
+    };
+
+    const auto blocksPerSecond = [](const auto function) {
+        const auto startTimer = std::chrono::high_resolution_clock::now();
+
+        for (uint64_t i = 0; i < BLOCK_ITERATIONS; i++)
+        {
+            function();
+        }
+
+        const auto elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+        return BLOCK_ITERATIONS / (std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / 1000000.0);
+    };
+
+    std::cout << "Block validation (" << FUSION_TRANSACTIONS_PER_BLOCK << " fusion transactions of "
+              << FUSION_TRANSACTION_INPUTS << " inputs, " << threadPool.threadCount() << " threads)" << std::endl;
+    std::cout << "Transaction at a time: " << blocksPerSecond(validateTransactionAtATime) << " blocks/s" << std::endl;
+    std::cout << "Block wide batch: " << blocksPerSecond(validateBlockAtOnce) << " blocks/s" << std::endl;
+}
+
+void benchmarkRandomOutputs()
+{
+    const std::string dataDir =
+        (std::filesystem::temp_directory_path() / ("cryptotest-" + std::to_string(Random::randomValue<uint32_t>())))
+            .string();
+
+    std::filesystem::create_directories(dataDir);
+
+    DataBaseConfig config;
+    config.init(dataDir, 2, 128, 64, 64, false);
+
+#if defined(USE_LEVELDB)
+    LevelDBWrapper database(std::make_shared<Logging::DummyLogger>());
+#else
+    RocksDBWrapper database(std::make_shared<Logging::DummyLogger>());
+#endif
+
+    database.init(config);
+
+    populateDatabase(database);
+
+    auto startTimer = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t i = 0; i < LOOP_ITERATIONS; i++)
+    {
+        pickFromDatabase(database);
+    }
+
+    const auto databaseTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+    startTimer = std::chrono::high_resolution_clock::now();
+
+    KeyOutputIndex index;
+    loadIndex(database, index);
+
+    const auto loadTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+    startTimer = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t i = 0; i < LOOP_ITERATIONS; i++)
+    {
+        std::vector<uint32_t> globalIndexes;
+        std::vector<Crypto::PublicKey> publicKeys;
+
+        index.pickRandomOutputs(
+            AMOUNT, OUTPUTS_TO_PICK, MAX_BLOCK_INDEX, [](const uint64_t) { return true; }, globalIndexes, publicKeys);
+    }
+
+    const auto indexTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+    database.shutdown();
+    database.destroy(config);
+
+    std::filesystem::remove_all(dataDir);
+
+    const auto requestsPerSecond = [](const auto elapsedTime) {
+        return static_cast<uint64_t>(
+            LOOP_ITERATIONS / (std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / 1000000.0));
+    };
+
+    std::cout << "Random outputs (database): " << requestsPerSecond(databaseTime) << " amounts/s" << std::endl;
+    std::cout << "Random outputs (key output index): " << requestsPerSecond(indexTime) << " amounts/s" << std::endl;
+    std::cout << "Key output index load time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(loadTime).count() << " ms" << std::endl;
+}
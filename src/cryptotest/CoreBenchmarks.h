@@ -0,0 +1,17 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+/* Compares picking random outputs for /getrandom_outs through database
+   lookups against the in memory key output index */
+void benchmarkRandomOutputs();
+
+/* Compares checking the inputs of a block full of large fusion transactions
+   a transaction at a time against as a single block wide batch */
+void benchmarkBlockSignatures();
+
+/* Compares running lots of small jobs on the std::function / std::future
+   based thread pool against the work stealing one */
+void benchmarkThreadPools();
@@ -2,6 +2,7 @@
 //
 // Please see the included LICENSE file for more information.
 
+#include "CoreBenchmarks.h"
 #include "CryptoNote.h"
 #include "CryptoTypes.h"
 #include "common/StringTools.h"
@@ -272,6 +273,89 @@ void benchmarkGenerateKeyDerivation()
     std::cout << "Time to perform generateKeyDerivation: " << timePerDerivation / 1000.0 << " ms" << std::endl;
 }
 
+/* Compares scanning a block worth of outputs one at a time against the
+   batched derivation API, reporting the throughput of each */
+void benchmarkOutputScanning()
+{
+    Crypto::SecretKey privateViewKey;
+    Common::podFromHex("89df8c4d34af41a51cfae0267e8254cadd2298f9256439fa1cfa7e25ee606606", privateViewKey);
+
+    /* Roughly a busy block - 100 transactions with 4 outputs each */
+    const size_t transactionCount = 100;
+    const size_t outputsPerTransaction = 4;
+    const uint64_t loopIterations = 20;
+
+    std::vector<Crypto::PublicKey> txPublicKeys;
+    std::vector<Crypto::OutputToUnderive> outputs;
+
+    for (size_t i = 0; i < transactionCount; i++)
+    {
+        Crypto::PublicKey publicKey;
+        Crypto::SecretKey secretKey;
+
+        Crypto::generate_keys(publicKey, secretKey);
+        txPublicKeys.push_back(publicKey);
+
+        for (size_t outputIndex = 0; outputIndex < outputsPerTransaction; outputIndex++)
+        {
+            Crypto::generate_keys(publicKey, secretKey);
+            outputs.push_back({i, outputIndex, publicKey});
+        }
+    }
+
+    std::vector<Crypto::PublicKey> singleResults(outputs.size());
+
+    auto startTimer = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t i = 0; i < loopIterations; i++)
+    {
+        std::vector<Crypto::KeyDerivation> derivations(txPublicKeys.size());
+
+        for (size_t j = 0; j < txPublicKeys.size(); j++)
+        {
+            Crypto::generate_key_derivation(txPublicKeys[j], privateViewKey, derivations[j]);
+        }
+
+        for (size_t j = 0; j < outputs.size(); j++)
+        {
+            Crypto::underive_public_key(
+                derivations[outputs[j].derivationIndex], outputs[j].outputIndex, outputs[j].outputKey, singleResults[j]);
+        }
+    }
+
+    const auto singleTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+    std::vector<Crypto::PublicKey> batchResults;
+
+    startTimer = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t i = 0; i < loopIterations; i++)
+    {
+        const auto derivations = Crypto::generate_key_derivations(txPublicKeys, privateViewKey);
+
+        batchResults = Crypto::underive_public_keys(derivations, outputs);
+    }
+
+    const auto batchTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+    if (singleResults != batchResults)
+    {
+        std::cout << "Batched output scanning does not match single output scanning!\nTerminating.";
+
+        exit(1);
+    }
+
+    const double totalOutputs = static_cast<double>(outputs.size() * loopIterations);
+
+    const auto outputsPerSecond = [totalOutputs](const auto elapsedTime) {
+        return static_cast<uint64_t>(
+            totalOutputs / std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() * 1000000);
+    };
+
+    std::cout << "Output scanning (single): " << outputsPerSecond(singleTime) << " outputs/s" << std::endl;
+    std::cout << "Output scanning (batched): " << outputsPerSecond(batchTime) << " outputs/s" << std::endl;
+}
+
 void TestDeterministicSubwalletCreation (const std::string baseSpendKey, const uint64_t subWalletIndex, const std::string expectedSpendKey)
 {
     Crypto::SecretKey f_baseSpendKey;
@@ -427,6 +511,10 @@ int main(int argc, char **argv)
 
             benchmarkUnderivePublicKey();
             benchmarkGenerateKeyDerivation();
+            benchmarkOutputScanning();
+            benchmarkRandomOutputs();
+            benchmarkThreadPools();
+            benchmarkBlockSignatures();
 
             BENCHMARK(cn_slow_hash_v0, o_iterations);
             BENCHMARK(cn_slow_hash_v1, o_iterations);
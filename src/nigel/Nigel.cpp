@@ -12,6 +12,7 @@
 #include <cryptonotecore/Core.h>
 #include <CryptoNote.h>
 #include <errors/ValidateParameters.h>
+#include <serialization/WalletSyncStream.h>
 #include <utilities/Utilities.h>
 #include <version.h>
 
@@ -89,6 +90,7 @@ void Nigel::swapNode(const std::string daemonHost, const uint16_t daemonPort, co
     m_nodeFeeAddress = "";
     m_nodeFeeAmount = 0;
     m_useRawBlocks = true;
+    m_useBinarySync = true;
 
     m_daemonHost = daemonHost;
     m_daemonPort = daemonPort;
@@ -213,6 +215,161 @@ std::tuple<bool, std::vector<WalletTypes::WalletBlockInfo>, std::optional<Wallet
     return { false, {}, std::nullopt };
 }
 
+std::tuple<bool, std::optional<WalletTypes::TopBlock>> Nigel::getWalletSyncDataStreamed(
+    const std::vector<Crypto::Hash> blockHashCheckpoints,
+    const uint64_t startHeight,
+    const uint64_t startTimestamp,
+    const bool skipCoinbaseTransactions,
+    const std::function<void(WalletTypes::WalletBlockInfo &&)> onBlock)
+{
+    if (!m_useBinarySync)
+    {
+        auto [success, blocks, topBlock] = getWalletSyncData(
+            blockHashCheckpoints,
+            startHeight,
+            startTimestamp,
+            skipCoinbaseTransactions
+        );
+
+        for (auto &block : blocks)
+        {
+            onBlock(std::move(block));
+        }
+
+        return {success, topBlock};
+    }
+
+    Logger::logger.log("Streaming blocks from the daemon", Logger::DEBUG, {Logger::SYNC, Logger::DAEMON});
+
+    const uint64_t blockCount = m_blockCount.load();
+
+    json j = {{"blockHashCheckpoints", blockHashCheckpoints},
+              {"startHeight", startHeight},
+              {"startTimestamp", startTimestamp},
+              {"blockCount", blockCount},
+              {"skipCoinbaseTransactions", skipCoinbaseTransactions}};
+
+    Logger::logger.log(
+        "Sending binary /getwalletsyncdata request to daemon: " + j.dump(),
+        Logger::TRACE,
+        { Logger::SYNC, Logger::DAEMON }
+    );
+
+    httplib::Headers headers = m_requestHeaders;
+
+    headers.emplace(
+        "Accept",
+        WalletSyncStream::CONTENT_TYPE_ZSTD + ", " + WalletSyncStream::CONTENT_TYPE + ", application/json"
+    );
+
+    std::optional<WalletTypes::TopBlock> topBlock;
+
+    std::unique_ptr<WalletSyncStream::Decoder> decoder;
+
+    /* Daemons which don't know about the binary format will ignore the
+       Accept header and send the usual JSON, which we collect here */
+    std::string jsonBody;
+
+    const auto receiver = [&](const httplib::Response &res, const char *data, size_t length)
+    {
+        if (res.status != 200)
+        {
+            jsonBody.append(data, length);
+            return true;
+        }
+
+        if (!decoder)
+        {
+            const std::string contentType = res.get_header_value("Content-Type");
+
+            if (contentType != WalletSyncStream::CONTENT_TYPE && contentType != WalletSyncStream::CONTENT_TYPE_ZSTD)
+            {
+                jsonBody.append(data, length);
+                return true;
+            }
+
+            /* The extra block's worth covers the top block and framing */
+            decoder = std::make_unique<WalletSyncStream::Decoder>(
+                contentType == WalletSyncStream::CONTENT_TYPE_ZSTD,
+                (blockCount + 1) * CryptoNote::WALLET_SYNC_STREAM_MAX_BLOCK_SIZE,
+                onBlock,
+                [&topBlock](const WalletTypes::TopBlock &top) { topBlock = top; }
+            );
+        }
+
+        return decoder->feed(data, length);
+    };
+
+    const auto res = m_nodeClient->Post(
+        "/getwalletsyncdata", headers, j.dump(), "application/json", receiver);
+
+    if (decoder)
+    {
+        if (res && decoder->isFinished())
+        {
+            return {true, topBlock};
+        }
+
+        Logger::logger.log(
+            "Failed to stream blocks from daemon - response was incomplete or malformed",
+            Logger::INFO,
+            { Logger::SYNC, Logger::DAEMON }
+        );
+
+        return {false, std::nullopt};
+    }
+
+    if (!res || res->status != 200)
+    {
+        if (res)
+        {
+            res->body = jsonBody;
+        }
+
+        /* Logs the failure reason */
+        tryParseJSONResponse(res, "Failed to fetch blocks from daemon", [](const nlohmann::json j) { return true; });
+
+        return {false, std::nullopt};
+    }
+
+    /* Older daemon, don't ask for the binary format again. The JSON we got
+       back is still a valid response, so use it. */
+    m_useBinarySync = false;
+
+    res->body = jsonBody;
+
+    const auto parsedResponse = tryParseJSONResponse(
+        res,
+        "Failed to fetch blocks from daemon",
+        [](const nlohmann::json j) {
+
+        auto items = j.at("items").get<std::vector<WalletTypes::WalletBlockInfo>>();
+
+        std::optional<WalletTypes::TopBlock> topBlock;
+
+        if (j.find("synced") != j.end() && j.find("topBlock") != j.end() && j.at("synced").get<bool>())
+        {
+            topBlock = j.at("topBlock").get<WalletTypes::TopBlock>();
+        }
+
+        return std::make_tuple(items, topBlock);
+    });
+
+    if (!parsedResponse)
+    {
+        return {false, std::nullopt};
+    }
+
+    auto [items, jsonTopBlock] = *parsedResponse;
+
+    for (auto &item : items)
+    {
+        onBlock(std::move(item));
+    }
+
+    return {true, jsonTopBlock};
+}
+
 void Nigel::stop()
 {
     m_shouldStop = true;
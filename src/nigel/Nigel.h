@@ -8,6 +8,7 @@
 #include "httplib.h"
 
 #include <atomic>
+#include <functional>
 #include <config/CryptoNoteConfig.h>
 #include <logger/Logger.h>
 #include <rpc/CoreRpcServerCommandsDefinitions.h>
@@ -65,6 +66,17 @@ class Nigel
         const uint64_t startTimestamp,
         const bool skipCoinbaseTransactions);
 
+    /* Like getWalletSyncData, but uses the binary format if the daemon
+       supports it, handing each block to onBlock as soon as it has been
+       received. Blocks may have been passed to onBlock even on failure.
+       Returns {success, topBlock} */
+    std::tuple<bool, std::optional<WalletTypes::TopBlock>> getWalletSyncDataStreamed(
+        const std::vector<Crypto::Hash> blockHashCheckpoints,
+        const uint64_t startHeight,
+        const uint64_t startTimestamp,
+        const bool skipCoinbaseTransactions,
+        const std::function<void(WalletTypes::WalletBlockInfo &&)> onBlock);
+
     /* Returns a bool on success or not */
     bool getTransactionsStatus(
         const std::unordered_set<Crypto::Hash> transactionHashes,
@@ -232,4 +244,7 @@ class Nigel
 
     /* Whether we should use /getrawblocks instead of /getwalletsyncdata */
     bool m_useRawBlocks = true;
+
+    /* Whether the daemon supports the binary /getwalletsyncdata format */
+    bool m_useBinarySync = true;
 };
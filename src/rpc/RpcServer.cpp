@@ -15,6 +15,7 @@
 #include <errors/ValidateParameters.h>
 #include <logger/Logger.h>
 #include <serialization/SerializationTools.h>
+#include <serialization/WalletSyncStream.h>
 #include <utilities/Addresses.h>
 #include <utilities/ColouredMsg.h>
 #include <utilities/FormatTools.h>
@@ -533,6 +534,14 @@ std::tuple<Error, uint16_t> RpcServer::info(
     writer.Key("start_time");
     writer.Uint64(m_core->getStartTime());
 
+    const auto [walletSyncCacheHits, walletSyncCacheMisses] = m_core->getWalletSyncCacheStatistics();
+
+    writer.Key("wallet_sync_cache_hits");
+    writer.Uint64(walletSyncCacheHits);
+
+    writer.Key("wallet_sync_cache_misses");
+    writer.Uint64(walletSyncCacheMisses);
+
     writer.EndObject();
 
     res.body = sb.GetString();
@@ -847,6 +856,25 @@ std::tuple<Error, uint16_t> RpcServer::getWalletSyncData(
         ? getBoolFromJSON(body, "skipCoinbaseTransactions")
         : false;
 
+    const std::string accept = req.get_header_value("Accept");
+
+    /* Client supports the binary format, stream it instead of building up
+       the JSON */
+    if (accept.find(WalletSyncStream::CONTENT_TYPE) != std::string::npos)
+    {
+        const bool compress = accept.find(WalletSyncStream::CONTENT_TYPE_ZSTD) != std::string::npos;
+
+        return streamWalletSyncData(
+            res,
+            compress,
+            blockHashCheckpoints,
+            startHeight,
+            startTimestamp,
+            blockCount,
+            skipCoinbaseTransactions
+        );
+    }
+
     std::vector<WalletTypes::WalletBlockInfo> walletBlocks;
     std::optional<WalletTypes::TopBlock> topBlockInfo;
 
@@ -1018,6 +1046,142 @@ std::tuple<Error, uint16_t> RpcServer::getWalletSyncData(
     return {SUCCESS, 200};
 }
 
+std::tuple<Error, uint16_t> RpcServer::streamWalletSyncData(
+    httplib::Response &res,
+    const bool compress,
+    const std::vector<Crypto::Hash> &blockHashCheckpoints,
+    const uint64_t startHeight,
+    const uint64_t startTimestamp,
+    const uint64_t blockCount,
+    const bool skipCoinbaseTransactions)
+{
+    uint64_t startIndex;
+    uint64_t actualBlockCount;
+    std::optional<WalletTypes::TopBlock> topBlockInfo;
+
+    const bool success = m_core->getWalletSyncRange(
+        blockHashCheckpoints,
+        startHeight,
+        startTimestamp,
+        blockCount,
+        startIndex,
+        actualBlockCount,
+        topBlockInfo
+    );
+
+    if (!success)
+    {
+        return {SUCCESS, 500};
+    }
+
+    /* Replace the application/json set in the middleware */
+    res.headers.erase("Content-Type");
+    res.set_header("Content-Type", compress ? WalletSyncStream::CONTENT_TYPE_ZSTD : WalletSyncStream::CONTENT_TYPE);
+
+    auto encoder = std::make_shared<WalletSyncStream::Encoder>(compress);
+
+    /* Nothing to stream, just send the top block */
+    if (topBlockInfo)
+    {
+        encoder->addTopBlock(*topBlockInfo);
+        encoder->finish();
+        res.body = encoder->takeOutput();
+
+        return {SUCCESS, 200};
+    }
+
+    struct StreamState
+    {
+        /* Next block index to read from */
+        uint64_t nextIndex;
+
+        /* Blocks left to send */
+        uint64_t remaining;
+
+        /* The last block we sent, so we can detect if it's been orphaned
+           while we were streaming */
+        std::optional<WalletTypes::TopBlock> lastBlock;
+
+        bool finished = false;
+    };
+
+    auto state = std::make_shared<StreamState>();
+
+    state->nextIndex = startIndex;
+    state->remaining = actualBlockCount;
+
+    /* Called repeatedly by the http server, each call reads a batch of blocks
+       and returns the encoded bytes, until we return an empty string */
+    res.streamcb = [this, encoder, state, skipCoinbaseTransactions](uint64_t /* offset */) -> std::string {
+        try
+        {
+            if (state->finished)
+            {
+                return std::string();
+            }
+
+            std::shared_ptr<const CryptoNote::WalletSyncCache::Chunk> chunk;
+
+            /* If the last block we sent is no longer in the main chain, stop
+               here. The wallet will notice the fork on its next request. */
+            const bool forked = state->lastBlock
+                && m_core->getBlockHashByIndex(static_cast<uint32_t>(state->lastBlock->height))
+                       != state->lastBlock->hash;
+
+            if (state->remaining > 0 && !forked)
+            {
+                const uint64_t batchSize = std::min(CryptoNote::WALLET_SYNC_STREAM_BATCH_SIZE, state->remaining);
+
+                chunk = m_core->getWalletSyncChunk(state->nextIndex, batchSize, skipCoinbaseTransactions);
+
+                if (!chunk)
+                {
+                    /* Terminate without an End frame so the client knows the
+                       response is incomplete */
+                    state->finished = true;
+                    return std::string();
+                }
+            }
+
+            if (!chunk || chunk->blockCount == 0)
+            {
+                /* Wallet is synced, let it know the top block */
+                if (!state->lastBlock)
+                {
+                    encoder->addTopBlock({m_core->getTopBlockHash(), m_core->getTopBlockIndex()});
+                }
+
+                encoder->finish();
+                state->finished = true;
+
+                return encoder->takeOutput();
+            }
+
+            encoder->addEncodedBlocks(chunk->data);
+
+            state->lastBlock = WalletTypes::TopBlock({chunk->lastBlockHash, chunk->lastBlockHeight});
+            state->nextIndex = chunk->lastBlockHeight + 1;
+            state->remaining -= chunk->blockCount;
+
+            return encoder->takeOutput();
+        }
+        catch (const std::exception &e)
+        {
+            Logger::logger.log(
+                std::string("Failed to stream wallet sync data: ") + e.what(),
+                Logger::WARNING,
+                { Logger::DAEMON_RPC }
+            );
+
+            state->finished = true;
+
+            return std::string();
+        }
+    };
+
+    return {SUCCESS, 200};
+}
+
 std::tuple<Error, uint16_t> RpcServer::getGlobalIndexes(
     const httplib::Request &req,
     httplib::Response &res,
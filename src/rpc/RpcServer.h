@@ -126,6 +126,17 @@ class RpcServer
     std::tuple<Error, uint16_t>
         getWalletSyncData(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
+    /* Binary variant of getWalletSyncData, streamed to the client as the
+       blocks are read */
+    std::tuple<Error, uint16_t> streamWalletSyncData(
+        httplib::Response &res,
+        const bool compress,
+        const std::vector<Crypto::Hash> &blockHashCheckpoints,
+        const uint64_t startHeight,
+        const uint64_t startTimestamp,
+        const uint64_t blockCount,
+        const bool skipCoinbaseTransactions);
+
     std::tuple<Error, uint16_t>
         getGlobalIndexes(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
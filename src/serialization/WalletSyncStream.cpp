@@ -0,0 +1,454 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "serialization/WalletSyncStream.h"
+
+#include "common/MemoryInputStream.h"
+#include "common/StringOutputStream.h"
+#include "common/Varint.h"
+#include "serialization/BinaryInputStreamSerializer.h"
+#include "serialization/BinaryOutputStreamSerializer.h"
+#include "serialization/WalletTypesSerialization.h"
+
+#include <stdexcept>
+#include <zstd/lib/zstd.h>
+
+namespace
+{
+    const char MAGIC[] = {'W', 'S', 'D'};
+
+    const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(WalletSyncStream::VERSION);
+
+    /* Guards against a malicious or broken peer making us allocate huge buffers */
+    const uint64_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+    /* Fast compression - we are optimizing for CPU time on the daemon, most
+       of the size reduction comes from the binary encoding */
+    const int COMPRESSION_LEVEL = 1;
+
+    /* Returns the amount of bytes the varint at offset occupies, zero if it
+       is not complete yet, or -1 if it is invalid */
+    int readLength(const std::string &buffer, const size_t offset, uint64_t &value)
+    {
+        value = 0;
+
+        for (size_t i = 0; offset + i < buffer.size(); i++)
+        {
+            /* More than 64 bits */
+            if (i == 10)
+            {
+                return -1;
+            }
+
+            const uint8_t byte = static_cast<uint8_t>(buffer[offset + i]);
+
+            value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+
+            if ((byte & 0x80) == 0)
+            {
+                return static_cast<int>(i + 1);
+            }
+        }
+
+        return 0;
+    }
+
+    /* Reads the frame at offset. Returns the size of the whole frame, or
+       zero if it is not complete yet. Throws if the frame is invalid. */
+    size_t readFrame(
+        const std::string &buffer,
+        const size_t offset,
+        WalletSyncStream::FrameType &type,
+        const char *&payload,
+        uint64_t &payloadSize)
+    {
+        if (offset >= buffer.size())
+        {
+            return 0;
+        }
+
+        type = static_cast<WalletSyncStream::FrameType>(buffer[offset]);
+
+        const int varintSize = readLength(buffer, offset + 1, payloadSize);
+
+        if (varintSize < 0 || payloadSize > MAX_FRAME_SIZE)
+        {
+            throw std::runtime_error("Invalid wallet sync frame length");
+        }
+
+        /* Length isn't all here yet */
+        if (varintSize == 0)
+        {
+            return 0;
+        }
+
+        const size_t payloadOffset = offset + 1 + varintSize;
+
+        /* Frame isn't all here yet */
+        if (buffer.size() - payloadOffset < payloadSize)
+        {
+            return 0;
+        }
+
+        payload = buffer.data() + payloadOffset;
+
+        return 1 + varintSize + payloadSize;
+    }
+
+    void appendFrame(std::string &output, const WalletSyncStream::FrameType type, const std::string &payload)
+    {
+        output.push_back(static_cast<char>(type));
+        Tools::write_varint(std::back_inserter(output), static_cast<uint64_t>(payload.size()));
+        output.append(payload);
+    }
+
+    template<typename T> std::string toBinary(const T &value)
+    {
+        std::string result;
+        Common::StringOutputStream stream(result);
+        CryptoNote::BinaryOutputStreamSerializer serializer(stream);
+        serialize(const_cast<T &>(value), serializer);
+        return result;
+    }
+
+    template<typename T> void fromBinary(T &value, const char *data, const size_t length)
+    {
+        Common::MemoryInputStream stream(data, length);
+        CryptoNote::BinaryInputStreamSerializer serializer(stream);
+        serialize(value, serializer);
+
+        if (!stream.endOfStream())
+        {
+            throw std::runtime_error("Trailing data in wallet sync frame");
+        }
+    }
+} // namespace
+
+namespace WalletSyncStream
+{
+    Encoder::Encoder(const bool compress)
+    {
+        if (compress)
+        {
+            m_compressor = ZSTD_createCCtx();
+
+            if (m_compressor == nullptr)
+            {
+                throw std::runtime_error("Failed to create zstd compression context");
+            }
+
+            ZSTD_CCtx_setParameter(m_compressor, ZSTD_c_compressionLevel, COMPRESSION_LEVEL);
+        }
+
+        m_pending.append(MAGIC, sizeof(MAGIC));
+        m_pending.push_back(static_cast<char>(VERSION));
+    }
+
+    Encoder::~Encoder()
+    {
+        ZSTD_freeCCtx(m_compressor);
+    }
+
+    void Encoder::addBlock(const WalletTypes::WalletBlockInfo &block)
+    {
+        addFrame(FrameType::Block, toBinary(block));
+    }
+
+    void Encoder::addEncodedBlocks(const std::string &frames)
+    {
+        if (m_finished)
+        {
+            throw std::logic_error("Cannot add a frame to a finished wallet sync stream");
+        }
+
+        m_pending.append(frames);
+    }
+
+    void Encoder::addTopBlock(const WalletTypes::TopBlock &topBlock)
+    {
+        addFrame(FrameType::TopBlock, toBinary(topBlock));
+    }
+
+    void Encoder::finish()
+    {
+        addFrame(FrameType::End, std::string());
+        m_finished = true;
+    }
+
+    void Encoder::addFrame(const FrameType type, const std::string &payload)
+    {
+        if (m_finished)
+        {
+            throw std::logic_error("Cannot add a frame to a finished wallet sync stream");
+        }
+
+        appendFrame(m_pending, type, payload);
+    }
+
+    std::string Encoder::takeOutput()
+    {
+        if (!m_compressor)
+        {
+            std::string output;
+            output.swap(m_pending);
+            return output;
+        }
+
+        std::string output;
+
+        ZSTD_inBuffer input = {m_pending.data(), m_pending.size(), 0};
+
+        const ZSTD_EndDirective mode = m_finished ? ZSTD_e_end : ZSTD_e_flush;
+
+        const size_t chunkSize = ZSTD_CStreamOutSize();
+
+        /* Keep going until zstd tells us everything has been flushed */
+        while (true)
+        {
+            const size_t offset = output.size();
+
+            output.resize(offset + chunkSize);
+
+            ZSTD_outBuffer out = {&output[offset], chunkSize, 0};
+
+            const size_t remaining = ZSTD_compressStream2(m_compressor, &out, &input, mode);
+
+            if (ZSTD_isError(remaining))
+            {
+                throw std::runtime_error(
+                    std::string("Failed to compress wallet sync data: ") + ZSTD_getErrorName(remaining));
+            }
+
+            output.resize(offset + out.pos);
+
+            if (remaining == 0)
+            {
+                break;
+            }
+        }
+
+        m_pending.clear();
+
+        return output;
+    }
+
+    std::string encodeBlocks(const std::vector<WalletTypes::WalletBlockInfo> &blocks)
+    {
+        std::string frames;
+
+        for (const auto &block : blocks)
+        {
+            appendFrame(frames, FrameType::Block, toBinary(block));
+        }
+
+        return frames;
+    }
+
+    std::vector<WalletTypes::WalletBlockInfo> decodeBlocks(const std::string &frames)
+    {
+        std::vector<WalletTypes::WalletBlockInfo> blocks;
+
+        size_t offset = 0;
+
+        while (offset < frames.size())
+        {
+            FrameType type;
+            const char *payload = nullptr;
+            uint64_t payloadSize = 0;
+
+            const size_t frameSize = readFrame(frames, offset, type, payload, payloadSize);
+
+            if (frameSize == 0 || type != FrameType::Block)
+            {
+                throw std::runtime_error("Invalid encoded wallet sync blocks");
+            }
+
+            WalletTypes::WalletBlockInfo block;
+            fromBinary(block, payload, payloadSize);
+            blocks.push_back(std::move(block));
+
+            offset += frameSize;
+        }
+
+        return blocks;
+    }
+
+    Decoder::Decoder(
+        const bool compressed,
+        const uint64_t maxSize,
+        const std::function<void(WalletTypes::WalletBlockInfo &&)> onBlock,
+        const std::function<void(const WalletTypes::TopBlock &)> onTopBlock):
+        m_maxSize(maxSize),
+        m_onBlock(onBlock),
+        m_onTopBlock(onTopBlock)
+    {
+        if (compressed)
+        {
+            m_decompressor = ZSTD_createDCtx();
+
+            if (m_decompressor == nullptr)
+            {
+                throw std::runtime_error("Failed to create zstd decompression context");
+            }
+        }
+    }
+
+    Decoder::~Decoder()
+    {
+        ZSTD_freeDCtx(m_decompressor);
+    }
+
+    bool Decoder::isFinished() const
+    {
+        return m_finished;
+    }
+
+    bool Decoder::feed(const char *data, const size_t length)
+    {
+        /* Data after the end frame. Checked before decompressing, as zstd
+           takes trailing bytes as the start of a new frame which yields
+           nothing yet, so processFrames() would never see them. */
+        if (m_finished)
+        {
+            return false;
+        }
+
+        /* Drop the bytes we have already parsed so the buffer doesn't grow
+           for the lifetime of the response */
+        m_buffer.erase(0, m_offset);
+        m_offset = 0;
+
+        if (!m_decompressor)
+        {
+            if (length > m_maxSize - m_decodedSize)
+            {
+                return false;
+            }
+
+            m_decodedSize += length;
+
+            m_buffer.append(data, length);
+        }
+        else
+        {
+            ZSTD_inBuffer input = {data, length, 0};
+
+            const size_t chunkSize = ZSTD_DStreamOutSize();
+
+            bool outputFull = false;
+
+            /* If the output buffer was filled, zstd may still be holding
+               decompressed data even though all the input is consumed */
+            while (input.pos < input.size || outputFull)
+            {
+                const size_t offset = m_buffer.size();
+
+                m_buffer.resize(offset + chunkSize);
+
+                ZSTD_outBuffer out = {&m_buffer[offset], chunkSize, 0};
+
+                const size_t result = ZSTD_decompressStream(m_decompressor, &out, &input);
+
+                m_buffer.resize(offset + out.pos);
+
+                if (ZSTD_isError(result))
+                {
+                    return false;
+                }
+
+                /* Checked every chunk, so a small input which inflates hugely
+                   is stopped before it is all decompressed */
+                m_decodedSize += out.pos;
+
+                if (m_decodedSize > m_maxSize)
+                {
+                    return false;
+                }
+
+                outputFull = out.pos == chunkSize;
+            }
+        }
+
+        try
+        {
+            return processFrames();
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+    }
+
+    bool Decoder::processFrames()
+    {
+        if (!m_headerRead)
+        {
+            if (m_buffer.size() < HEADER_SIZE)
+            {
+                return true;
+            }
+
+            if (m_buffer.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0
+                || static_cast<uint8_t>(m_buffer[sizeof(MAGIC)]) != VERSION)
+            {
+                return false;
+            }
+
+            m_offset = HEADER_SIZE;
+            m_headerRead = true;
+        }
+
+        while (m_offset < m_buffer.size())
+        {
+            /* Data after the end frame */
+            if (m_finished)
+            {
+                return false;
+            }
+
+            FrameType type;
+            const char *payload = nullptr;
+            uint64_t payloadSize = 0;
+
+            const size_t frameSize = readFrame(m_buffer, m_offset, type, payload, payloadSize);
+
+            /* Wait for the rest of the frame */
+            if (frameSize == 0)
+            {
+                return true;
+            }
+
+            switch (type)
+            {
+                case FrameType::End:
+                {
+                    m_finished = true;
+                    break;
+                }
+                case FrameType::Block:
+                {
+                    WalletTypes::WalletBlockInfo block;
+                    fromBinary(block, payload, payloadSize);
+                    m_onBlock(std::move(block));
+                    break;
+                }
+                case FrameType::TopBlock:
+                {
+                    WalletTypes::TopBlock topBlock;
+                    fromBinary(topBlock, payload, payloadSize);
+                    m_onTopBlock(topBlock);
+                    break;
+                }
+                default:
+                {
+                    return false;
+                }
+            }
+
+            m_offset += frameSize;
+        }
+
+        return true;
+    }
+} // namespace WalletSyncStream
@@ -0,0 +1,137 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <WalletTypes.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/* Forward declare so we don't leak zstd into every includer */
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+/* A binary alternative to the JSON /getwalletsyncdata response.
+
+   The stream starts with a 4 byte header, the magic "WSD" followed by the
+   format version. After this comes a sequence of frames, each made up of a
+   one byte frame type, a varint payload length, and the payload, which is
+   the WalletTypes struct written with the BinaryOutputStreamSerializer.
+   The stream is terminated by an End frame.
+
+   When the zstd content type is negotiated, the whole stream (header
+   included) is compressed as a single zstd frame, which is flushed after
+   every batch of blocks so the client can decode blocks as they arrive. */
+namespace WalletSyncStream
+{
+    /* Sent by clients in the Accept header, and by the daemon in the
+       Content-Type header */
+    const std::string CONTENT_TYPE = "application/x-walletsyncdata";
+
+    const std::string CONTENT_TYPE_ZSTD = "application/x-walletsyncdata+zstd";
+
+    const uint8_t VERSION = 1;
+
+    enum class FrameType : uint8_t
+    {
+        End = 0,
+        Block = 1,
+        TopBlock = 2,
+    };
+
+    class Encoder
+    {
+      public:
+        explicit Encoder(const bool compress);
+
+        ~Encoder();
+
+        Encoder(const Encoder &) = delete;
+
+        Encoder &operator=(const Encoder &) = delete;
+
+        void addBlock(const WalletTypes::WalletBlockInfo &block);
+
+        /* Adds blocks previously encoded with encodeBlocks() */
+        void addEncodedBlocks(const std::string &frames);
+
+        void addTopBlock(const WalletTypes::TopBlock &topBlock);
+
+        /* Writes the End frame. Nothing may be added after this. */
+        void finish();
+
+        /* Returns the bytes which are ready to be sent to the client since the
+           last call, compressing them if required. */
+        std::string takeOutput();
+
+      private:
+        void addFrame(const FrameType type, const std::string &payload);
+
+        /* Uncompressed bytes not yet returned from takeOutput() */
+        std::string m_pending;
+
+        bool m_finished = false;
+
+        ZSTD_CCtx *m_compressor = nullptr;
+    };
+
+    /* Encodes the blocks as a sequence of Block frames, which can be cached
+       and later passed to Encoder::addEncodedBlocks() */
+    std::string encodeBlocks(const std::vector<WalletTypes::WalletBlockInfo> &blocks);
+
+    /* The inverse of encodeBlocks(). Throws on malformed input. */
+    std::vector<WalletTypes::WalletBlockInfo> decodeBlocks(const std::string &frames);
+
+    class Decoder
+    {
+      public:
+        /* Once more than maxSize bytes have been decoded, the data is
+           treated as malformed, so a malicious or broken daemon can't make
+           us allocate without bound */
+        Decoder(
+            const bool compressed,
+            const uint64_t maxSize,
+            const std::function<void(WalletTypes::WalletBlockInfo &&)> onBlock,
+            const std::function<void(const WalletTypes::TopBlock &)> onTopBlock);
+
+        ~Decoder();
+
+        Decoder(const Decoder &) = delete;
+
+        Decoder &operator=(const Decoder &) = delete;
+
+        /* Feed the next piece of the response body in. The callbacks are
+           invoked for every complete frame. Returns false if the data is
+           malformed, after which the decoder should be discarded. */
+        bool feed(const char *data, const size_t length);
+
+        /* Whether we have seen the End frame */
+        bool isFinished() const;
+
+      private:
+        bool processFrames();
+
+        /* Decompressed bytes not yet parsed into frames */
+        std::string m_buffer;
+
+        /* Read offset into m_buffer */
+        size_t m_offset = 0;
+
+        const uint64_t m_maxSize;
+
+        /* Bytes of the stream decoded so far, after decompression */
+        uint64_t m_decodedSize = 0;
+
+        bool m_headerRead = false;
+
+        bool m_finished = false;
+
+        ZSTD_DCtx *m_decompressor = nullptr;
+
+        std::function<void(WalletTypes::WalletBlockInfo &&)> m_onBlock;
+
+        std::function<void(const WalletTypes::TopBlock &)> m_onTopBlock;
+    };
+} // namespace WalletSyncStream
@@ -0,0 +1,79 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "serialization/WalletTypesSerialization.h"
+
+#include "serialization/CryptoNoteSerialization.h"
+#include "serialization/SerializationOverloads.h"
+
+namespace
+{
+    /* ISerializer has no notion of an optional value, so we prefix the value
+       with a flag indicating whether it is present */
+    template<typename T>
+    void serializeOptional(std::optional<T> &value, Common::StringView name, CryptoNote::ISerializer &serializer)
+    {
+        bool hasValue = value.has_value();
+
+        serializer(hasValue, "has_value");
+
+        if (serializer.type() == CryptoNote::ISerializer::INPUT)
+        {
+            if (hasValue)
+            {
+                T item;
+                serializer(item, name);
+                value = std::move(item);
+            }
+            else
+            {
+                value.reset();
+            }
+        }
+        else if (hasValue)
+        {
+            serializer(*value, name);
+        }
+    }
+} // namespace
+
+namespace WalletTypes
+{
+    void serialize(KeyOutput &output, CryptoNote::ISerializer &serializer)
+    {
+        serializer(output.key, "key");
+        serializer(output.amount, "amount");
+        serializeOptional(output.globalOutputIndex, "globalOutputIndex", serializer);
+    }
+
+    void serialize(RawCoinbaseTransaction &transaction, CryptoNote::ISerializer &serializer)
+    {
+        serializer(transaction.keyOutputs, "outputs");
+        serializer(transaction.hash, "hash");
+        serializer(transaction.transactionPublicKey, "txPublicKey");
+        serializer(transaction.unlockTime, "unlockTime");
+    }
+
+    void serialize(RawTransaction &transaction, CryptoNote::ISerializer &serializer)
+    {
+        serialize(static_cast<RawCoinbaseTransaction &>(transaction), serializer);
+        serializer(transaction.paymentID, "paymentID");
+        serializer(transaction.keyInputs, "inputs");
+    }
+
+    void serialize(WalletBlockInfo &block, CryptoNote::ISerializer &serializer)
+    {
+        serializeOptional(block.coinbaseTransaction, "coinbaseTX", serializer);
+        serializer(block.transactions, "transactions");
+        serializer(block.blockHeight, "blockHeight");
+        serializer(block.blockHash, "blockHash");
+        serializer(block.blockTimestamp, "blockTimestamp");
+    }
+
+    void serialize(TopBlock &topBlock, CryptoNote::ISerializer &serializer)
+    {
+        serializer(topBlock.hash, "hash");
+        serializer(topBlock.height, "height");
+    }
+} // namespace WalletTypes
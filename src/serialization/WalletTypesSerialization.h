@@ -0,0 +1,22 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "serialization/ISerializer.h"
+
+#include <WalletTypes.h>
+
+namespace WalletTypes
+{
+    void serialize(KeyOutput &output, CryptoNote::ISerializer &serializer);
+
+    void serialize(RawCoinbaseTransaction &transaction, CryptoNote::ISerializer &serializer);
+
+    void serialize(RawTransaction &transaction, CryptoNote::ISerializer &serializer);
+
+    void serialize(WalletBlockInfo &block, CryptoNote::ISerializer &serializer);
+
+    void serialize(TopBlock &topBlock, CryptoNote::ISerializer &serializer);
+} // namespace WalletTypes
@@ -0,0 +1,35 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoTypes.h>
+#include <crypto/random.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/* Each file in tests/ is a program of its own, which ctest runs. A check
+   which fails prints what went wrong and exits with a non zero status. */
+namespace Tests
+{
+    inline void check(const bool condition, const std::string &description)
+    {
+        if (!condition)
+        {
+            std::cout << "Failed: " << description << std::endl;
+
+            exit(1);
+        }
+    }
+
+    inline Crypto::Hash randomHash()
+    {
+        Crypto::Hash hash;
+
+        Random::randomBytes(sizeof(hash.data), hash.data);
+
+        return hash;
+    }
+} // namespace Tests
@@ -0,0 +1,161 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <algorithm>
+#include <config/Constants.h>
+#include <crypto/crypto.h>
+#include <tests/TestUtilities.h>
+
+using Tests::check;
+
+namespace
+{
+    const size_t KEY_COUNT = 64;
+
+    /* Random bytes which don't decode to a point on the curve */
+    Crypto::PublicKey invalidKey()
+    {
+        Crypto::PublicKey key;
+
+        do
+        {
+            Random::randomBytes(sizeof(key.data), key.data);
+        } while (Crypto::check_key(key));
+
+        return key;
+    }
+
+    /* Derives a batch of random transaction keys, one of which is invalid,
+       and checks each derivation matches deriving that key on its own */
+    void testDerivations(std::vector<Crypto::PublicKey> &publicKeys, Crypto::SecretKey &viewKey)
+    {
+        Crypto::PublicKey viewPublicKey;
+        Crypto::generate_keys(viewPublicKey, viewKey);
+
+        for (size_t i = 0; i < KEY_COUNT; i++)
+        {
+            Crypto::PublicKey publicKey;
+            Crypto::SecretKey secretKey;
+            Crypto::generate_keys(publicKey, secretKey);
+
+            publicKeys.push_back(publicKey);
+        }
+
+        publicKeys[KEY_COUNT / 2] = invalidKey();
+
+        const auto derivations = Crypto::generate_key_derivations(publicKeys, viewKey);
+
+        check(derivations.size() == publicKeys.size(), "a derivation is returned for every key");
+
+        const auto isZero = [](const Crypto::KeyDerivation &derivation) {
+            return std::all_of(std::begin(derivation.data), std::end(derivation.data), [](const uint8_t byte) {
+                return byte == 0;
+            });
+        };
+
+        for (size_t i = 0; i < publicKeys.size(); i++)
+        {
+            Crypto::KeyDerivation derivation;
+
+            const bool valid = Crypto::generate_key_derivation(publicKeys[i], viewKey, derivation);
+
+            if (i == KEY_COUNT / 2)
+            {
+                check(!valid, "deriving an invalid key on its own fails");
+                check(isZero(derivations[i]), "an invalid key gives a zeroed derivation");
+            }
+            else
+            {
+                check(valid, "deriving a valid key on its own succeeds");
+                check(derivations[i] == derivation, "a batched derivation matches deriving the key on its own");
+            }
+        }
+
+        check(Crypto::generate_key_derivations({}, viewKey).empty(), "deriving no keys gives no derivations");
+    }
+
+    /* Underives the outputs of each transaction, with an invalid output key
+       part way through, and checks each against underiving it on its own */
+    void testUnderiving(const std::vector<Crypto::PublicKey> &publicKeys, const Crypto::SecretKey &viewKey)
+    {
+        const auto derivations = Crypto::generate_key_derivations(publicKeys, viewKey);
+
+        Crypto::PublicKey spendKey;
+        Crypto::SecretKey spendSecretKey;
+        Crypto::generate_keys(spendKey, spendSecretKey);
+
+        std::vector<Crypto::OutputToUnderive> outputs;
+
+        for (size_t i = 0; i < derivations.size(); i++)
+        {
+            for (size_t outputIndex = 0; outputIndex < 3; outputIndex++)
+            {
+                Crypto::PublicKey outputKey;
+
+                /* Half of the outputs belong to the spend key, the rest are
+                   random keys belonging to someone else */
+                if (outputIndex % 2 == 0)
+                {
+                    Crypto::derive_public_key(derivations[i], outputIndex, spendKey, outputKey);
+                }
+                else
+                {
+                    Crypto::SecretKey secretKey;
+                    Crypto::generate_keys(outputKey, secretKey);
+                }
+
+                outputs.push_back({i, outputIndex, outputKey});
+            }
+        }
+
+        const size_t invalidOutput = outputs.size() / 2 + 1;
+
+        outputs[invalidOutput].outputKey = invalidKey();
+
+        const auto bases = Crypto::underive_public_keys(derivations, outputs);
+
+        check(bases.size() == outputs.size(), "a base key is returned for every output");
+
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            const auto &output = outputs[i];
+
+            Crypto::PublicKey base;
+
+            const bool valid = Crypto::underive_public_key(
+                derivations[output.derivationIndex], output.outputIndex, output.outputKey, base);
+
+            if (i == invalidOutput)
+            {
+                check(!valid, "underiving an invalid output key on its own fails");
+                check(bases[i] == Constants::NULL_PUBLIC_KEY, "an invalid output key gives a zeroed base key");
+            }
+            else
+            {
+                check(valid, "underiving a valid output key on its own succeeds");
+                check(bases[i] == base, "a batched base key matches underiving the output on its own");
+            }
+
+            /* The outputs of the invalid transaction key were derived from a
+               zeroed derivation, so they still come back to the spend key */
+            if (i != invalidOutput && output.outputIndex % 2 == 0)
+            {
+                check(bases[i] == spendKey, "an output sent to the spend key underives to it");
+            }
+        }
+
+        check(Crypto::underive_public_keys(derivations, {}).empty(), "underiving no outputs gives no base keys");
+    }
+} // namespace
+
+int main()
+{
+    std::vector<Crypto::PublicKey> publicKeys;
+    Crypto::SecretKey viewKey;
+
+    testDerivations(publicKeys, viewKey);
+    testUnderiving(publicKeys, viewKey);
+
+    std::cout << "Passed." << std::endl;
+}
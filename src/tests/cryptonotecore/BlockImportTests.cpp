@@ -0,0 +1,215 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <common/CryptoNoteTools.h>
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/Checkpoints.h>
+#include <cryptonotecore/Core.h>
+#include <cryptonotecore/Currency.h>
+#include <cryptonotecore/DataBaseConfig.h>
+#include <cryptonotecore/DatabaseBlockchainCache.h>
+#include <cryptonotecore/DatabaseBlockchainCacheFactory.h>
+#include <cryptonotecore/MainChainStorage.h>
+#if defined(USE_LEVELDB)
+#include <cryptonotecore/LevelDBWrapper.h>
+#else
+#include <cryptonotecore/RocksDBWrapper.h>
+#endif
+#include <filesystem>
+#include <functional>
+#include <logging/DummyLogger.h>
+#include <optional>
+#include <system/Dispatcher.h>
+#include <tests/TestUtilities.h>
+
+using namespace CryptoNote;
+using Tests::check;
+
+namespace
+{
+    /* Two and a half batches, so the last batch is only partly full */
+    const uint32_t BLOCK_COUNT = IMPORT_BLOCKS_BATCH_SIZE * 2 + IMPORT_BLOCKS_BATCH_SIZE / 2;
+
+    /* Partway through the second batch of the import */
+    const uint32_t CORRUPTED_BLOCK_INDEX = IMPORT_BLOCKS_BATCH_SIZE + IMPORT_BLOCKS_BATCH_SIZE / 2;
+
+    /* Pushes empty blocks onto the storage until it holds BLOCK_COUNT, adding
+       their hashes to blockHashes, which holds the hash of every block already
+       stored. The block at corruptedIndex, if any, doesn't follow on from its
+       parent. */
+    void fillStorage(
+        IMainChainStorage &storage,
+        const Currency &currency,
+        std::vector<Crypto::Hash> &blockHashes,
+        const std::optional<uint32_t> corruptedIndex)
+    {
+        for (uint32_t index = storage.getBlockCount(); index < BLOCK_COUNT; index++)
+        {
+            BlockTemplate block;
+            block.majorVersion = BLOCK_MAJOR_VERSION_1;
+            block.minorVersion = BLOCK_MINOR_VERSION_0;
+            block.nonce = 0;
+            block.timestamp = currency.genesisBlock().timestamp + index;
+            block.previousBlockHash = index == corruptedIndex ? Tests::randomHash() : blockHashes.back();
+            block.baseTransaction.version = CURRENT_TRANSACTION_VERSION;
+            block.baseTransaction.unlockTime = 0;
+            block.baseTransaction.inputs.push_back(BaseInput {index});
+
+            blockHashes.push_back(CachedBlock(block).getBlockHash());
+
+            RawBlock rawBlock;
+            rawBlock.block = toBinaryArray(block);
+
+            storage.pushBlock(rawBlock);
+        }
+    }
+
+    /* Loads a core on top of the storage, which imports whatever of it isn't
+       in the database yet. Returns false if the import was abandoned. */
+    bool importBlocks(
+        IDataBase &database,
+        std::unique_ptr<IMainChainStorage> storage,
+        const Currency &currency,
+        const std::function<void(const Core &)> &onImported)
+    {
+        const auto logger = std::make_shared<Logging::DummyLogger>();
+
+        System::Dispatcher dispatcher;
+
+        Core core(
+            currency,
+            logger,
+            Checkpoints(logger),
+            dispatcher,
+            std::make_unique<DatabaseBlockchainCacheFactory>(database, logger),
+            std::move(storage),
+            1);
+
+        try
+        {
+            core.load();
+        }
+        catch (const std::system_error &)
+        {
+            return false;
+        }
+
+        onImported(core);
+
+        return true;
+    }
+
+    /* The index of the top block written to the database */
+    uint32_t getStoredTopBlockIndex(IDataBase &database, const Currency &currency)
+    {
+        const auto logger = std::make_shared<Logging::DummyLogger>();
+
+        DatabaseBlockchainCacheFactory factory(database, logger);
+
+        DatabaseBlockchainCache cache(currency, database, factory, logger);
+
+        return cache.getTopBlockIndex();
+    }
+
+    /* Checks the core holds exactly the blocks with the given hashes */
+    void checkChain(const Core &core, const std::vector<Crypto::Hash> &blockHashes)
+    {
+        check(core.getTopBlockIndex() == blockHashes.size() - 1, "every block in the storage is imported");
+
+        for (uint32_t index = 0; index < blockHashes.size(); index++)
+        {
+            check(core.getBlockHashByIndex(index) == blockHashes[index], "blocks are imported in order");
+        }
+    }
+
+    /* Every batch, including the last partly full one, is imported */
+    void testImport(IDataBase &database, const std::string &dataDir)
+    {
+        const Currency currency = CurrencyBuilder(std::make_shared<Logging::DummyLogger>()).currency();
+
+        auto storage = createSwappedMainChainStorage(dataDir, currency);
+
+        std::vector<Crypto::Hash> blockHashes {CachedBlock(currency.genesisBlock()).getBlockHash()};
+
+        fillStorage(*storage, currency, blockHashes, std::nullopt);
+
+        const bool imported = importBlocks(database, std::move(storage), currency, [&](const Core &core) {
+            checkChain(core, blockHashes);
+        });
+
+        check(imported, "a valid chain is imported");
+        check(getStoredTopBlockIndex(database, currency) == BLOCK_COUNT - 1, "imported blocks are written");
+    }
+
+    /* An import which fails partway through keeps the batches committed
+       before the failure and drops the one it was writing. Once the storage
+       is repaired, the import picks up from the last committed batch. */
+    void testAbortedImport(IDataBase &database, const std::string &dataDir)
+    {
+        const Currency currency = CurrencyBuilder(std::make_shared<Logging::DummyLogger>()).currency();
+
+        auto storage = createSwappedMainChainStorage(dataDir, currency);
+
+        std::vector<Crypto::Hash> blockHashes {CachedBlock(currency.genesisBlock()).getBlockHash()};
+
+        fillStorage(*storage, currency, blockHashes, CORRUPTED_BLOCK_INDEX);
+
+        const bool imported = importBlocks(database, std::move(storage), currency, [](const Core &) {});
+
+        check(!imported, "an import of a corrupted chain is abandoned");
+        check(
+            getStoredTopBlockIndex(database, currency) == IMPORT_BLOCKS_BATCH_SIZE,
+            "an abandoned import keeps the batches committed before it failed, and drops the rest");
+
+        storage = createSwappedMainChainStorage(dataDir, currency);
+
+        while (storage->getBlockCount() > CORRUPTED_BLOCK_INDEX)
+        {
+            storage->popBlock();
+        }
+
+        blockHashes.resize(CORRUPTED_BLOCK_INDEX);
+
+        fillStorage(*storage, currency, blockHashes, std::nullopt);
+
+        const bool resumed = importBlocks(database, std::move(storage), currency, [&](const Core &core) {
+            checkChain(core, blockHashes);
+        });
+
+        check(resumed, "an abandoned import resumes once the storage is repaired");
+    }
+} // namespace
+
+int main()
+{
+    for (const auto test : {testImport, testAbortedImport})
+    {
+        const std::string name = "blockimporttests-" + std::to_string(Random::randomValue<uint32_t>());
+
+        const std::string dataDir = (std::filesystem::temp_directory_path() / name).string();
+
+        std::filesystem::create_directories(dataDir);
+
+        DataBaseConfig config;
+        config.init(dataDir, 2, 128, 64, 64, false);
+
+#if defined(USE_LEVELDB)
+        LevelDBWrapper database(std::make_shared<Logging::DummyLogger>());
+#else
+        RocksDBWrapper database(std::make_shared<Logging::DummyLogger>());
+#endif
+
+        database.init(config);
+
+        test(database, dataDir);
+
+        database.shutdown();
+        database.destroy(config);
+
+        std::filesystem::remove_all(dataDir);
+    }
+
+    std::cout << "Passed." << std::endl;
+}
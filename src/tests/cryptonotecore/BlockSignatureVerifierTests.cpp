@@ -0,0 +1,278 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/BlockSignatureVerifier.h>
+#include <cryptonotecore/BlockchainCache.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/Checkpoints.h>
+#include <cryptonotecore/Currency.h>
+#include <cryptonotecore/TransactionValidationErrors.h>
+#include <cryptonotecore/ValidateTransaction.h>
+#include <deque>
+#include <logging/DummyLogger.h>
+#include <tests/TestUtilities.h>
+
+using namespace CryptoNote;
+using Tests::check;
+
+namespace
+{
+    const uint64_t AMOUNT = 1234567;
+
+    const size_t TRANSACTION_COUNT = 16;
+
+    const size_t INPUTS_PER_TRANSACTION = 4;
+
+    /* Each run schedules the runners differently, so the result is checked
+       over many of them */
+    const size_t RUNS = 50;
+
+    const size_t THREAD_COUNT = 4;
+
+    /* A chain with a single block, whose outputs the transactions spend */
+    class Chain
+    {
+      public:
+        Chain():
+            m_logger(std::make_shared<Logging::DummyLogger>()),
+            m_currency(CurrencyBuilder(m_logger).currency()),
+            m_checkpoints(m_logger),
+            m_cache("", m_currency, m_logger, nullptr),
+            m_threadPool(THREAD_COUNT)
+        {
+            Transaction funding;
+            funding.version = CURRENT_TRANSACTION_VERSION;
+            funding.unlockTime = 0;
+
+            for (size_t i = 0; i < TRANSACTION_COUNT * INPUTS_PER_TRANSACTION; i++)
+            {
+                KeyOutput output;
+                Crypto::SecretKey secretKey;
+
+                Crypto::generate_keys(output.key, secretKey);
+
+                funding.outputs.push_back({AMOUNT, output});
+                m_keys.emplace_back(output.key, secretKey);
+            }
+
+            BlockTemplate block;
+            block.majorVersion = BLOCK_MAJOR_VERSION_1;
+            block.minorVersion = BLOCK_MINOR_VERSION_0;
+            block.nonce = 0;
+            block.timestamp = 0;
+            block.previousBlockHash = m_cache.getTopBlockHash();
+            block.baseTransaction.version = CURRENT_TRANSACTION_VERSION;
+            block.baseTransaction.unlockTime = 0;
+            block.baseTransaction.inputs.push_back(BaseInput {1});
+
+            m_cache.pushBlock(CachedBlock(block), {CachedTransaction(std::move(funding))}, {}, 1, 0, 1, RawBlock());
+
+            for (size_t i = 0; i < TRANSACTION_COUNT; i++)
+            {
+                m_transactions.push_back(createTransaction(i));
+            }
+        }
+
+        /* Makes the signature of one of the transaction's inputs invalid */
+        void corruptSignature(const size_t transactionIndex, const size_t inputIndex)
+        {
+            Transaction transaction = m_transactions[transactionIndex].getTransaction();
+
+            transaction.signatures[inputIndex][0].data[0] ^= 1;
+
+            m_transactions[transactionIndex] = CachedTransaction(std::move(transaction));
+        }
+
+        /* Adds an input which isn't a key input, so checking it throws. The
+           transaction is signed again, so its other inputs stay valid. */
+        void addInvalidInput(const size_t transactionIndex)
+        {
+            m_transactions[transactionIndex] = createTransaction(transactionIndex, true);
+        }
+
+        /* Checks every transaction as one batch, the way a block is */
+        std::optional<size_t> verify()
+        {
+            TransactionValidatorState state;
+            std::deque<ValidateTransaction> validators;
+            BlockSignatureVerifier verifier(m_threadPool);
+
+            for (const auto &transaction : m_transactions)
+            {
+                auto &validator = validators.emplace_back(
+                    transaction, state, &m_cache, m_currency, m_checkpoints, m_threadPool, 1, 1000000, false);
+
+                verifier.addTransaction(validator);
+            }
+
+            const auto failure = verifier.verify();
+
+            if (failure)
+            {
+                m_lastError = validators[*failure].getValidationResult().errorCode;
+            }
+
+            return failure;
+        }
+
+        std::error_code getLastError() const
+        {
+            return m_lastError;
+        }
+
+      private:
+        /* Spends the outputs of the funding transaction in order, with no
+           decoys */
+        CachedTransaction createTransaction(const size_t transactionIndex, const bool invalidInput = false)
+        {
+            Transaction transaction;
+            transaction.version = CURRENT_TRANSACTION_VERSION;
+            transaction.unlockTime = 0;
+
+            for (size_t i = 0; i < INPUTS_PER_TRANSACTION; i++)
+            {
+                const uint32_t globalIndex = static_cast<uint32_t>(transactionIndex * INPUTS_PER_TRANSACTION + i);
+                const auto &[publicKey, secretKey] = m_keys[globalIndex];
+
+                KeyInput input;
+                input.amount = AMOUNT;
+                input.outputIndexes = {globalIndex};
+
+                Crypto::generate_key_image(publicKey, secretKey, input.keyImage);
+
+                transaction.inputs.push_back(input);
+            }
+
+            KeyOutput output;
+            Crypto::SecretKey ignored;
+            Crypto::generate_keys(output.key, ignored);
+
+            transaction.outputs.push_back({AMOUNT * INPUTS_PER_TRANSACTION - 10, output});
+
+            if (invalidInput)
+            {
+                transaction.inputs.push_back(BaseInput {1});
+            }
+
+            const Crypto::Hash prefixHash = CachedTransaction(transaction).getTransactionPrefixHash();
+
+            for (size_t i = 0; i < INPUTS_PER_TRANSACTION; i++)
+            {
+                const auto &[publicKey, secretKey] = m_keys[transactionIndex * INPUTS_PER_TRANSACTION + i];
+
+                const auto [success, signatures] = Crypto::crypto_ops::generateRingSignatures(
+                    prefixHash, boost::get<KeyInput>(transaction.inputs[i]).keyImage, {publicKey}, secretKey, 0);
+
+                check(success, "ring signatures are generated");
+
+                transaction.signatures.push_back(signatures);
+            }
+
+            if (invalidInput)
+            {
+                transaction.signatures.push_back({});
+            }
+
+            return CachedTransaction(std::move(transaction));
+        }
+
+        std::shared_ptr<Logging::DummyLogger> m_logger;
+
+        Currency m_currency;
+
+        Checkpoints m_checkpoints;
+
+        BlockchainCache m_cache;
+
+        Utilities::WorkStealingThreadPool m_threadPool;
+
+        std::vector<std::tuple<Crypto::PublicKey, Crypto::SecretKey>> m_keys;
+
+        std::vector<CachedTransaction> m_transactions;
+
+        std::error_code m_lastError;
+    };
+
+    void testValid()
+    {
+        Chain chain;
+
+        check(!chain.verify(), "a batch of valid transactions verifies");
+    }
+
+    /* However the inputs are shared out between the threads, the failure
+       reported is the first in the order the transactions were added */
+    void testFirstFailure()
+    {
+        Chain chain;
+
+        chain.corruptSignature(12, 0);
+        chain.corruptSignature(5, INPUTS_PER_TRANSACTION - 1);
+
+        for (size_t i = 0; i < RUNS; i++)
+        {
+            const auto failure = chain.verify();
+
+            check(failure && *failure == 5, "the first transaction with an invalid input is returned");
+        }
+
+        check(
+            chain.getLastError() == error::TransactionValidationError::INPUT_INVALID_SIGNATURES,
+            "the failed transaction's validation result holds the reason");
+    }
+
+    /* An exception checking an input reaches the caller, once every runner
+       has stopped */
+    void testException()
+    {
+        Chain chain;
+
+        chain.addInvalidInput(TRANSACTION_COUNT / 2);
+
+        for (size_t i = 0; i < RUNS; i++)
+        {
+            bool threw = false;
+
+            try
+            {
+                chain.verify();
+            }
+            catch (const std::exception &)
+            {
+                threw = true;
+            }
+
+            check(threw, "an exception checking an input is rethrown by verify()");
+        }
+
+        /* A failure before the input which throws can stop the runners first,
+           either way the batch must not be reported as valid */
+        chain.corruptSignature(0, 0);
+
+        for (size_t i = 0; i < RUNS; i++)
+        {
+            try
+            {
+                const auto failure = chain.verify();
+
+                check(failure && *failure == 0, "a failure before the throwing input is returned");
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+    }
+} // namespace
+
+int main()
+{
+    testValid();
+    testFirstFailure();
+    testException();
+
+    std::cout << "Passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <algorithm>
+#include <common/CryptoNoteTools.h>
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/CachedTransaction.h>
+#include <cryptonotecore/Currency.h>
+#include <cryptonotecore/DataBaseConfig.h>
+#include <cryptonotecore/DatabaseBlockchainCache.h>
+#include <cryptonotecore/DatabaseBlockchainCacheFactory.h>
+#include <cryptonotecore/KeyOutputIndex.h>
+#include <filesystem>
+#include <logging/DummyLogger.h>
+#include <numeric>
+#include <tests/TestUtilities.h>
+
+#if defined(USE_LEVELDB)
+#include <cryptonotecore/LevelDBWrapper.h>
+#else
+#include <cryptonotecore/RocksDBWrapper.h>
+#endif
+
+using namespace CryptoNote;
+using Tests::check;
+
+namespace
+{
+    /* Not an amount the genesis block pays out */
+    const uint64_t AMOUNT = 12345;
+
+    /* Far enough past every block pushed that all their outputs can be
+       picked */
+    const uint32_t SPEND_BLOCK_INDEX = 1000;
+
+    Crypto::PublicKey randomKey()
+    {
+        Crypto::PublicKey key;
+
+        Random::randomBytes(sizeof(key.data), key.data);
+
+        return key;
+    }
+
+    bool isSorted(const std::vector<uint32_t> &globalIndexes)
+    {
+        return std::adjacent_find(globalIndexes.begin(), globalIndexes.end(), std::greater_equal<uint32_t>())
+               == globalIndexes.end();
+    }
+
+    /* Loading amounts on first use, keeping them in step with pushes, and
+       dropping them when they fall out of step */
+    void testLoading()
+    {
+        KeyOutputIndex index;
+
+        std::vector<uint32_t> globalIndexes;
+        std::vector<Crypto::PublicKey> publicKeys;
+
+        const auto always = [](const uint64_t) { return true; };
+
+        check(!index.isLoaded(AMOUNT), "an amount isn't loaded until it's asked for");
+        check(
+            !index.pickRandomOutputs(AMOUNT, 1, 0, always, globalIndexes, publicKeys),
+            "picking outputs of an amount which isn't loaded fails");
+
+        index.push(AMOUNT, 0, {randomKey(), 0, 0});
+
+        check(index.size() == 0, "outputs pushed to an amount which isn't loaded are dropped");
+
+        std::vector<KeyOutputIndex::Output> outputs;
+
+        /* One output per block, every other one locked */
+        for (uint32_t blockIndex = 0; blockIndex < 10; blockIndex++)
+        {
+            outputs.push_back({randomKey(), blockIndex, blockIndex % 2});
+        }
+
+        index.load(AMOUNT, std::vector<KeyOutputIndex::Output>(outputs));
+
+        check(index.isLoaded(AMOUNT), "an amount is loaded once its outputs are set");
+
+        index.push(AMOUNT, 10, {randomKey(), 10, 0});
+
+        check(index.size() == 11, "an output pushed in order is appended");
+
+        index.push(AMOUNT, 20, {randomKey(), 20, 0});
+
+        check(!index.isLoaded(AMOUNT), "an output pushed out of order drops the amount, to be reloaded");
+
+        index.load(AMOUNT, std::vector<KeyOutputIndex::Output>(outputs));
+
+        const auto unlockedOnly = [](const uint64_t unlockTime) { return unlockTime == 0; };
+
+        check(
+            index.pickRandomOutputs(AMOUNT, 100, 6, unlockedOnly, globalIndexes, publicKeys),
+            "picking outputs of a loaded amount");
+
+        check(
+            globalIndexes == std::vector<uint32_t> {0, 2, 4, 6},
+            "asking for more outputs than there are gives every unlocked output old enough");
+
+        for (size_t i = 0; i < globalIndexes.size(); i++)
+        {
+            check(publicKeys[i] == outputs[globalIndexes[i]].publicKey, "each output comes with its public key");
+        }
+
+        for (int i = 0; i < 100; i++)
+        {
+            globalIndexes.clear();
+            publicKeys.clear();
+
+            index.pickRandomOutputs(AMOUNT, 3, 9, always, globalIndexes, publicKeys);
+
+            check(globalIndexes.size() == 3, "the number of outputs asked for are picked");
+            check(isSorted(globalIndexes), "picked outputs are unique and sorted by global index");
+        }
+
+        index.truncate(AMOUNT, 4);
+
+        check(index.size() == 4, "truncating removes the outputs at or above the count");
+
+        index.truncate(AMOUNT, 5);
+
+        check(!index.isLoaded(AMOUNT), "truncating to more outputs than are held drops the amount");
+    }
+
+    /* A block paying count outputs of AMOUNT, on top of the cache */
+    void pushBlock(DatabaseBlockchainCache &cache, const size_t count)
+    {
+        Transaction transaction;
+        transaction.version = CURRENT_TRANSACTION_VERSION;
+        transaction.unlockTime = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            KeyOutput output;
+            output.key = randomKey();
+
+            transaction.outputs.push_back({AMOUNT, output});
+        }
+
+        BlockTemplate block;
+        block.majorVersion = BLOCK_MAJOR_VERSION_1;
+        block.minorVersion = BLOCK_MINOR_VERSION_0;
+        block.nonce = 0;
+        block.timestamp = cache.getTopBlockIndex() + 1;
+        block.previousBlockHash = cache.getTopBlockHash();
+        block.baseTransaction.version = CURRENT_TRANSACTION_VERSION;
+        block.baseTransaction.unlockTime = 0;
+        block.baseTransaction.inputs.push_back(BaseInput {cache.getTopBlockIndex() + 1});
+
+        const CachedTransaction cachedTransaction(std::move(transaction));
+
+        block.transactionHashes.push_back(cachedTransaction.getTransactionHash());
+
+        const CachedBlock cachedBlock(block);
+
+        /* Split reads the blocks it moves back from their raw form */
+        RawBlock rawBlock;
+        rawBlock.block = toBinaryArray(block);
+        rawBlock.transactions.emplace_back(cachedTransaction.getTransactionBinaryArray());
+
+        cache.pushBlock(cachedBlock, {cachedTransaction}, {}, 1, 0, 1, std::move(rawBlock));
+    }
+
+    std::vector<uint32_t> pickEveryOutput(const DatabaseBlockchainCache &cache)
+    {
+        std::vector<uint32_t> globalIndexes;
+        std::vector<Crypto::PublicKey> publicKeys;
+
+        cache.getRandomKeyOutputsByAmount(AMOUNT, 100, SPEND_BLOCK_INDEX, globalIndexes, publicKeys);
+
+        return globalIndexes;
+    }
+
+    std::vector<uint32_t> firstOutputs(const uint32_t count)
+    {
+        std::vector<uint32_t> globalIndexes(count);
+
+        std::iota(globalIndexes.begin(), globalIndexes.end(), 0);
+
+        return globalIndexes;
+    }
+
+    /* Outputs pushed in a write batch can't be picked until the batch is
+       committed, and outputs split off the chain can't be picked at all */
+    void testDatabaseCache(IDataBase &database)
+    {
+        const auto logger = std::make_shared<Logging::DummyLogger>();
+
+        const Currency currency = CurrencyBuilder(logger).currency();
+
+        DatabaseBlockchainCacheFactory factory(database, logger);
+
+        DatabaseBlockchainCache cache(currency, database, factory, logger);
+
+        pushBlock(cache, 10);
+
+        check(pickEveryOutput(cache) == firstOutputs(10), "the outputs of a pushed block can be picked");
+
+        cache.beginWriteBatch();
+        pushBlock(cache, 5);
+
+        check(pickEveryOutput(cache) == firstOutputs(10), "outputs in an open write batch can't be picked");
+
+        cache.discardWriteBatch();
+
+        check(pickEveryOutput(cache) == firstOutputs(10), "outputs in a discarded write batch can't be picked");
+        check(cache.getTopBlockIndex() == 1, "a discarded write batch leaves the top block as it was");
+
+        cache.beginWriteBatch();
+        pushBlock(cache, 5);
+        cache.commitWriteBatch();
+
+        check(pickEveryOutput(cache) == firstOutputs(15), "outputs in a committed write batch can be picked");
+
+        pushBlock(cache, 5);
+
+        check(pickEveryOutput(cache) == firstOutputs(20), "outputs pushed after a write batch can be picked");
+
+        const auto alternative = cache.split(3);
+
+        check(pickEveryOutput(cache) == firstOutputs(15), "outputs split off the chain can't be picked");
+    }
+} // namespace
+
+int main()
+{
+    testLoading();
+
+    const std::string name = "keyoutputindextests-" + std::to_string(Random::randomValue<uint32_t>());
+
+    const std::string dataDir = (std::filesystem::temp_directory_path() / name).string();
+
+    std::filesystem::create_directories(dataDir);
+
+    DataBaseConfig config;
+    config.init(dataDir, 2, 128, 64, 64, false);
+
+#if defined(USE_LEVELDB)
+    LevelDBWrapper database(std::make_shared<Logging::DummyLogger>());
+#else
+    RocksDBWrapper database(std::make_shared<Logging::DummyLogger>());
+#endif
+
+    database.init(config);
+
+    testDatabaseCache(database);
+
+    database.shutdown();
+    database.destroy(config);
+
+    std::filesystem::remove_all(dataDir);
+
+    std::cout << "Passed." << std::endl;
+}
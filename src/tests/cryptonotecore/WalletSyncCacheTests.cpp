@@ -0,0 +1,129 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <cryptonotecore/WalletSyncCache.h>
+#include <tests/TestUtilities.h>
+
+using namespace CryptoNote;
+using Tests::check;
+
+namespace
+{
+    std::shared_ptr<const WalletSyncCache::Chunk>
+        makeChunk(const uint64_t startIndex, const uint64_t blockCount, const bool reachedTop)
+    {
+        auto chunk = std::make_shared<WalletSyncCache::Chunk>();
+
+        chunk->data = std::string(100, 'x');
+        chunk->blockCount = blockCount;
+        chunk->lastBlockHeight = startIndex + blockCount - 1;
+        chunk->lastBlockHash = Tests::randomHash();
+        chunk->reachedTop = reachedTop;
+
+        return chunk;
+    }
+
+    /* Chunks are looked up by every part of the request */
+    void testLookup()
+    {
+        WalletSyncCache cache(1024 * 1024);
+
+        const auto chunk = makeChunk(0, 100, false);
+
+        check(cache.get(0, 100, false) == nullptr, "a chunk which hasn't been inserted isn't cached");
+
+        cache.insert(0, 100, false, chunk, cache.getGeneration());
+
+        check(cache.get(0, 100, false) == chunk, "an inserted chunk is cached");
+        check(cache.get(0, 100, true) == nullptr, "a chunk skipping coinbase transactions is cached apart");
+        check(cache.get(1, 100, false) == nullptr, "a chunk starting elsewhere is cached apart");
+
+        const auto [hits, misses] = cache.getStatistics();
+
+        check(hits == 1 && misses == 3, "hits and misses are counted");
+    }
+
+    /* A chain switch drops the chunks with blocks from the split onwards,
+       and those built from the chain before it */
+    void testChainSwitch()
+    {
+        WalletSyncCache cache(1024 * 1024);
+
+        const auto below = makeChunk(0, 100, false);
+        const auto across = makeChunk(100, 100, false);
+        const auto above = makeChunk(200, 100, false);
+        const auto top = makeChunk(50, 10, true);
+
+        cache.insert(0, 100, false, below, cache.getGeneration());
+        cache.insert(100, 100, false, across, cache.getGeneration());
+        cache.insert(200, 100, false, above, cache.getGeneration());
+        cache.insert(50, 10, false, top, cache.getGeneration());
+
+        /* Read before the switch, and stored after it */
+        const uint64_t generation = cache.getGeneration();
+        const auto stale = makeChunk(300, 100, false);
+
+        cache.onChainSwitch(150);
+
+        check(cache.get(0, 100, false) == below, "a chunk below the split is kept");
+        check(cache.get(100, 100, false) == nullptr, "a chunk containing the split is dropped");
+        check(cache.get(200, 100, false) == nullptr, "a chunk above the split is dropped");
+        check(cache.get(50, 10, false) == nullptr, "a chunk which reached the top is dropped");
+
+        cache.insert(300, 100, false, stale, generation);
+
+        check(cache.get(300, 100, false) == nullptr, "a chunk built before the chain switch isn't stored");
+
+        cache.insert(100, 100, false, across, cache.getGeneration());
+
+        check(cache.get(100, 100, false) == across, "a chunk built after the chain switch is stored");
+    }
+
+    /* A new block only drops the chunks which reached the top */
+    void testNewBlock()
+    {
+        WalletSyncCache cache(1024 * 1024);
+
+        const auto full = makeChunk(0, 100, false);
+        const auto top = makeChunk(100, 10, true);
+
+        cache.insert(0, 100, false, full, cache.getGeneration());
+        cache.insert(100, 10, false, top, cache.getGeneration());
+
+        cache.onNewBlock();
+
+        check(cache.get(0, 100, false) == full, "a full chunk is kept when a block is added");
+        check(cache.get(100, 10, false) == nullptr, "a chunk which reached the top is dropped");
+    }
+
+    /* The least recently used chunks are evicted once the cache is full */
+    void testEviction()
+    {
+        WalletSyncCache cache(400);
+
+        for (uint64_t startIndex = 0; startIndex < 400; startIndex += 100)
+        {
+            cache.insert(startIndex, 100, false, makeChunk(startIndex, 100, false), cache.getGeneration());
+        }
+
+        /* Used most recently, so the next insert evicts the chunk at 100 */
+        cache.get(0, 100, false);
+
+        cache.insert(400, 100, false, makeChunk(400, 100, false), cache.getGeneration());
+
+        check(cache.get(0, 100, false) != nullptr, "a recently used chunk is kept");
+        check(cache.get(100, 100, false) == nullptr, "the least recently used chunk is evicted");
+        check(cache.get(400, 100, false) != nullptr, "the new chunk is stored");
+    }
+} // namespace
+
+int main()
+{
+    testLookup();
+    testChainSwitch();
+    testNewBlock();
+    testEviction();
+
+    std::cout << "Passed." << std::endl;
+}
@@ -0,0 +1,252 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <serialization/WalletSyncStream.h>
+#include <tests/TestUtilities.h>
+
+using Tests::check;
+using Tests::randomHash;
+
+namespace
+{
+    Crypto::PublicKey randomKey()
+    {
+        Crypto::PublicKey key;
+
+        Random::randomBytes(sizeof(key.data), key.data);
+
+        return key;
+    }
+
+    WalletTypes::RawCoinbaseTransaction randomCoinbase()
+    {
+        WalletTypes::RawCoinbaseTransaction transaction;
+
+        transaction.keyOutputs.push_back({randomKey(), 100, std::nullopt});
+        transaction.keyOutputs.push_back({randomKey(), 2000, 42});
+        transaction.hash = randomHash();
+        transaction.transactionPublicKey = randomKey();
+        transaction.unlockTime = 10;
+
+        return transaction;
+    }
+
+    /* Blocks with and without a coinbase transaction, with and without
+       global indexes, and with no transactions at all */
+    std::vector<WalletTypes::WalletBlockInfo> randomBlocks()
+    {
+        std::vector<WalletTypes::WalletBlockInfo> blocks;
+
+        for (uint64_t height = 100; height < 105; height++)
+        {
+            WalletTypes::WalletBlockInfo block;
+
+            if (height % 2 == 0)
+            {
+                block.coinbaseTransaction = randomCoinbase();
+            }
+
+            for (uint64_t i = 100; i < height; i++)
+            {
+                WalletTypes::RawTransaction transaction;
+
+                static_cast<WalletTypes::RawCoinbaseTransaction &>(transaction) = randomCoinbase();
+
+                transaction.paymentID = i % 2 == 0 ? "" : std::string(64, 'a');
+
+                CryptoNote::KeyInput input;
+                input.amount = 500;
+                input.outputIndexes = {1, 5, 9};
+                Random::randomBytes(sizeof(input.keyImage.data), input.keyImage.data);
+
+                transaction.keyInputs.push_back(input);
+
+                block.transactions.push_back(transaction);
+            }
+
+            block.blockHeight = height;
+            block.blockHash = randomHash();
+            block.blockTimestamp = 1500000000 + height;
+
+            blocks.push_back(block);
+        }
+
+        return blocks;
+    }
+
+    /* Compares every field the stream carries */
+    bool equal(const WalletTypes::RawCoinbaseTransaction &a, const WalletTypes::RawCoinbaseTransaction &b)
+    {
+        if (a.keyOutputs.size() != b.keyOutputs.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.keyOutputs.size(); i++)
+        {
+            if (!(a.keyOutputs[i].key == b.keyOutputs[i].key) || a.keyOutputs[i].amount != b.keyOutputs[i].amount
+                || a.keyOutputs[i].globalOutputIndex != b.keyOutputs[i].globalOutputIndex)
+            {
+                return false;
+            }
+        }
+
+        return a.hash == b.hash && a.transactionPublicKey == b.transactionPublicKey && a.unlockTime == b.unlockTime;
+    }
+
+    bool equal(const WalletTypes::RawTransaction &a, const WalletTypes::RawTransaction &b)
+    {
+        if (!equal(
+                static_cast<const WalletTypes::RawCoinbaseTransaction &>(a),
+                static_cast<const WalletTypes::RawCoinbaseTransaction &>(b))
+            || a.paymentID != b.paymentID || a.keyInputs.size() != b.keyInputs.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.keyInputs.size(); i++)
+        {
+            if (a.keyInputs[i].amount != b.keyInputs[i].amount
+                || a.keyInputs[i].outputIndexes != b.keyInputs[i].outputIndexes
+                || !(a.keyInputs[i].keyImage == b.keyInputs[i].keyImage))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool equal(const std::vector<WalletTypes::WalletBlockInfo> &a, const std::vector<WalletTypes::WalletBlockInfo> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].coinbaseTransaction.has_value() != b[i].coinbaseTransaction.has_value()
+                || (a[i].coinbaseTransaction && !equal(*a[i].coinbaseTransaction, *b[i].coinbaseTransaction))
+                || a[i].transactions.size() != b[i].transactions.size() || a[i].blockHeight != b[i].blockHeight
+                || a[i].blockHash != b[i].blockHash || a[i].blockTimestamp != b[i].blockTimestamp)
+            {
+                return false;
+            }
+
+            for (size_t j = 0; j < a[i].transactions.size(); j++)
+            {
+                if (!equal(a[i].transactions[j], b[i].transactions[j]))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void testEncodedBlocks()
+    {
+        const auto blocks = randomBlocks();
+
+        const std::string frames = WalletSyncStream::encodeBlocks(blocks);
+
+        check(equal(WalletSyncStream::decodeBlocks(frames), blocks), "encoded blocks decode to the same blocks");
+        check(WalletSyncStream::decodeBlocks("").empty(), "no frames decode to no blocks");
+
+        bool threw = false;
+
+        try
+        {
+            WalletSyncStream::decodeBlocks(frames.substr(0, frames.size() - 1));
+        }
+        catch (const std::exception &)
+        {
+            threw = true;
+        }
+
+        check(threw, "decoding blocks cut short throws");
+    }
+
+    /* Streams the blocks, part of them cached with encodeBlocks(), and feeds
+       the response to a decoder a few bytes at a time */
+    void testStream(const bool compress)
+    {
+        const auto blocks = randomBlocks();
+
+        const WalletTypes::TopBlock topBlock {randomHash(), 12345};
+
+        WalletSyncStream::Encoder encoder(compress);
+
+        encoder.addBlock(blocks[0]);
+        encoder.addBlock(blocks[1]);
+
+        std::string response = encoder.takeOutput();
+
+        encoder.addEncodedBlocks(WalletSyncStream::encodeBlocks({blocks.begin() + 2, blocks.end()}));
+        encoder.addTopBlock(topBlock);
+        encoder.finish();
+
+        response += encoder.takeOutput();
+
+        std::vector<WalletTypes::WalletBlockInfo> decodedBlocks;
+        std::optional<WalletTypes::TopBlock> decodedTopBlock;
+
+        WalletSyncStream::Decoder decoder(
+            compress,
+            1024 * 1024,
+            [&](WalletTypes::WalletBlockInfo &&block) { decodedBlocks.push_back(std::move(block)); },
+            [&](const WalletTypes::TopBlock &block) { decodedTopBlock = block; });
+
+        for (size_t offset = 0; offset < response.size(); offset += 7)
+        {
+            const size_t length = std::min<size_t>(7, response.size() - offset);
+
+            check(decoder.feed(response.data() + offset, length), "feeding a valid stream a few bytes at a time");
+        }
+
+        check(decoder.isFinished(), "the decoder sees the end of the stream");
+        check(equal(decodedBlocks, blocks), "streamed blocks decode to the same blocks");
+        check(
+            decodedTopBlock && decodedTopBlock->hash == topBlock.hash && decodedTopBlock->height == topBlock.height,
+            "the streamed top block decodes to the same top block");
+
+        check(!decoder.feed(response.data(), 1), "data after the end of the stream is rejected");
+
+        WalletSyncStream::Decoder smallDecoder(
+            compress, response.size() / 2, [](WalletTypes::WalletBlockInfo &&) {}, [](const WalletTypes::TopBlock &) {});
+
+        check(
+            !smallDecoder.feed(response.data(), response.size()),
+            "a stream larger than the decoder's maximum size is rejected");
+    }
+
+    void testMalformed()
+    {
+        WalletSyncStream::Decoder decoder(
+            false, 1024, [](WalletTypes::WalletBlockInfo &&) {}, [](const WalletTypes::TopBlock &) {});
+
+        const std::string wrongMagic = "XYZ\x01";
+
+        check(!decoder.feed(wrongMagic.data(), wrongMagic.size()), "a stream with the wrong magic is rejected");
+
+        WalletSyncStream::Decoder unknownFrame(
+            false, 1024, [](WalletTypes::WalletBlockInfo &&) {}, [](const WalletTypes::TopBlock &) {});
+
+        const std::string frame = std::string("WSD\x01") + '\x09' + '\x00';
+
+        check(!unknownFrame.feed(frame.data(), frame.size()), "a frame of an unknown type is rejected");
+    }
+} // namespace
+
+int main()
+{
+    testEncodedBlocks();
+    testStream(false);
+    testStream(true);
+    testMalformed();
+
+    std::cout << "Passed." << std::endl;
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <atomic>
+#include <tests/TestUtilities.h>
+#include <utilities/WorkStealingThreadPool.h>
+#include <vector>
+
+using Tests::check;
+
+namespace
+{
+    const size_t JOB_COUNT = 10000;
+
+    /* Checks every job submitted singly and in bulk runs exactly once, and
+       has finished by the time wait() returns */
+    void testEachJobRunsOnce(Utilities::WorkStealingThreadPool &pool)
+    {
+        std::vector<std::atomic<uint32_t>> runs(JOB_COUNT * 2);
+
+        Utilities::WaitGroup waitGroup;
+
+        for (size_t i = 0; i < JOB_COUNT; i++)
+        {
+            std::atomic<uint32_t> *run = &runs[i];
+
+            pool.submit(waitGroup, [run] { (*run)++; });
+        }
+
+        std::atomic<uint32_t> *bulkRuns = &runs[JOB_COUNT];
+
+        pool.submitBulk(waitGroup, JOB_COUNT, [bulkRuns](const size_t index) { bulkRuns[index]++; });
+
+        /* Nothing to wait for, and nothing queued */
+        pool.submitBulk(waitGroup, 0, [bulkRuns](const size_t index) { bulkRuns[index]++; });
+
+        pool.wait(waitGroup);
+
+        check(waitGroup.finished(), "the wait group is finished once wait() returns");
+
+        for (const auto &run : runs)
+        {
+            check(run == 1, "every job runs exactly once");
+        }
+    }
+
+    /* A job which submits two jobs like itself and waits for them, down to
+       the given depth */
+    struct NestedJob
+    {
+        Utilities::WorkStealingThreadPool *pool;
+
+        std::atomic<uint32_t> *leaves;
+
+        void run(const size_t depth) const
+        {
+            if (depth == 0)
+            {
+                (*leaves)++;
+                return;
+            }
+
+            Utilities::WaitGroup waitGroup;
+
+            const NestedJob *self = this;
+
+            pool->submitBulk(waitGroup, 2, [self, depth](const size_t) { self->run(depth - 1); });
+
+            pool->wait(waitGroup);
+        }
+    };
+
+    /* Nests jobs more deeply than there are threads, which only finishes if
+       threads waiting inside a job run queued jobs rather than blocking */
+    void testNestedJobs(Utilities::WorkStealingThreadPool &pool)
+    {
+        const size_t depth = pool.threadCount() + 2;
+
+        std::atomic<uint32_t> leaves = 0;
+
+        const NestedJob nested {&pool, &leaves};
+
+        const NestedJob *root = &nested;
+
+        Utilities::WaitGroup waitGroup;
+
+        pool.submit(waitGroup, [root, depth] { root->run(depth); });
+
+        pool.wait(waitGroup);
+
+        check(leaves == 1u << depth, "jobs submitted from inside a job all run");
+
+        leaves = 0;
+
+        nested.run(depth);
+
+        check(leaves == 1u << depth, "nested jobs submitted from outside the pool all run");
+    }
+
+    /* Destroying the pool finishes the jobs still queued */
+    void testDestructorFinishesJobs()
+    {
+        std::atomic<uint32_t> runs = 0;
+
+        Utilities::WaitGroup waitGroup;
+
+        {
+            Utilities::WorkStealingThreadPool pool(2);
+
+            std::atomic<uint32_t> *counter = &runs;
+
+            pool.submitBulk(waitGroup, JOB_COUNT, [counter](const size_t) { (*counter)++; });
+        }
+
+        check(runs == JOB_COUNT, "the pool runs its queued jobs before it is destroyed");
+        check(waitGroup.finished(), "the wait group of jobs finished by the destructor is finished");
+    }
+} // namespace
+
+int main()
+{
+    /* More threads than this machine has cores, so the threads steal from
+       each other even on a single core */
+    Utilities::WorkStealingThreadPool pool(4);
+
+    testEachJobRunsOnce(pool);
+    testNestedJobs(pool);
+    testDestructorFinishesJobs();
+
+    /* A pool asked for no threads still gets one */
+    check(Utilities::WorkStealingThreadPool(0).threadCount() == 1, "a pool always has a thread");
+
+    std::cout << "Passed." << std::endl;
+}
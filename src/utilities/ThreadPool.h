@@ -87,6 +87,11 @@ namespace Utilities
                 return result;
             }
 
+            uint64_t threadCount() const
+            {
+                return m_threadCount;
+            }
+
         private:
 
             //////////////////////////////
@@ -74,7 +74,7 @@ template<typename T> class ThreadSafeDeque
         }
 
         /* Add the item to the front of the queue */
-        m_deque.push_back(item);
+        m_deque.push_back(std::move(item));
 
         /* Unlock the mutex before notifying, so it doesn't block after
            waking up */
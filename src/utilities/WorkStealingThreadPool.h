@@ -0,0 +1,438 @@
+// Copyright (c) 2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Utilities
+{
+    /* Counts the outstanding jobs of a group, so the submitter can wait for
+       them all to finish */
+    class WaitGroup
+    {
+        public:
+            void add(const size_t count)
+            {
+                m_pending += count;
+            }
+
+            void done()
+            {
+                /* Decrement under the lock, otherwise a waiter could see zero,
+                 * return and destroy us before we notify it */
+                std::scoped_lock<std::mutex> lock(m_mutex);
+
+                if (--m_pending == 0)
+                {
+                    m_finished.notify_all();
+                }
+            }
+
+            bool finished() const
+            {
+                return m_pending == 0;
+            }
+
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                m_finished.wait(lock, [this] {
+                    return m_pending == 0;
+                });
+            }
+
+        private:
+            std::atomic<size_t> m_pending = 0;
+
+            std::mutex m_mutex;
+
+            std::condition_variable m_finished;
+    };
+
+    /* A thread pool for lots of small jobs, such as checking signatures.
+     *
+     * Each thread has its own deque of jobs. A thread runs the newest job of
+     * its own deque, and when that is empty, steals the oldest job from
+     * another thread's deque. Jobs submitted from a pool thread go on its own
+     * deque, others are spread between the threads.
+     *
+     * Jobs are stored inline rather than in a std::function, and completion
+     * is tracked with a WaitGroup rather than a promise per job, so once the
+     * deques have grown to their working size, submitting a job doesn't
+     * allocate. In exchange, jobs must be small, trivially copyable callables
+     * (capture by reference or pointer), and must not throw. */
+    class WorkStealingThreadPool
+    {
+        public:
+            /////////////////
+            /* CONSTRUCTOR */
+            /////////////////
+
+            WorkStealingThreadPool() : WorkStealingThreadPool(std::thread::hardware_concurrency())
+            {
+            }
+
+            WorkStealingThreadPool(uint64_t threadCount)
+            {
+                if (threadCount == 0)
+                {
+                    threadCount = 1;
+                }
+
+                for (uint64_t i = 0; i < threadCount; i++)
+                {
+                    m_workers.push_back(std::make_unique<Worker>());
+                }
+
+                /* Launch the threads once every deque exists, since they
+                 * steal from each other straight away */
+                for (uint64_t i = 0; i < threadCount; i++)
+                {
+                    m_workers[i]->thread = std::thread(&WorkStealingThreadPool::workerLoop, this, i);
+                }
+            }
+
+            ////////////////
+            /* DESTRUCTOR */
+            ////////////////
+
+            /* Finishes any jobs still queued before stopping */
+            ~WorkStealingThreadPool()
+            {
+                {
+                    std::scoped_lock<std::mutex> lock(m_sleepMutex);
+                    m_shouldStop = true;
+                }
+
+                m_haveJob.notify_all();
+
+                for (auto &worker : m_workers)
+                {
+                    worker->thread.join();
+                }
+            }
+
+            /////////////////////////////
+            /* PUBLIC MEMBER FUNCTIONS */
+            /////////////////////////////
+
+            /* Queues job(), and marks it done in waitGroup once it has run */
+            template<typename Job> void submit(WaitGroup &waitGroup, const Job &job)
+            {
+                waitGroup.add(1);
+
+                push(Task(job, waitGroup, 0));
+
+                wakeThreads(false);
+            }
+
+            /* Queues job(0) through job(count - 1), marking each done in
+             * waitGroup once it has run */
+            template<typename Job> void submitBulk(WaitGroup &waitGroup, const size_t count, const Job &job)
+            {
+                if (count == 0)
+                {
+                    return;
+                }
+
+                waitGroup.add(count);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    push(Task(job, waitGroup, i));
+                }
+
+                wakeThreads(count > 1);
+            }
+
+            /* Waits for every job in the group to finish. Rather than idling,
+             * the calling thread runs queued jobs until there are none left
+             * to take, so this is safe to call from inside a job. */
+            void wait(WaitGroup &waitGroup)
+            {
+                Task task;
+
+                while (!waitGroup.finished() && takeTask(currentWorkerIndex(), task))
+                {
+                    task.run();
+                }
+
+                waitGroup.wait();
+            }
+
+            uint64_t threadCount() const
+            {
+                return m_workers.size();
+            }
+
+        private:
+            ///////////////////
+            /* PRIVATE TYPES */
+            ///////////////////
+
+            class Task
+            {
+                public:
+                    /* Big enough for a lambda capturing a handful of
+                     * references */
+                    static constexpr size_t STORAGE_SIZE = 48;
+
+                    Task() = default;
+
+                    template<typename Job> Task(const Job &job, WaitGroup &waitGroup, const size_t index) :
+                        m_waitGroup(&waitGroup),
+                        m_index(index)
+                    {
+                        static_assert(sizeof(Job) <= STORAGE_SIZE, "Job is too large to store inline");
+                        static_assert(alignof(Job) <= alignof(std::max_align_t), "Job is over aligned");
+                        static_assert(std::is_trivially_copyable_v<Job>, "Job must be trivially copyable");
+                        static_assert(std::is_trivially_destructible_v<Job>, "Job must be trivially destructible");
+
+                        std::memcpy(m_storage, &job, sizeof(Job));
+
+                        m_invoke = [](const void *storage, const size_t index) {
+                            const Job &job = *static_cast<const Job *>(storage);
+
+                            if constexpr (std::is_invocable_v<const Job &, size_t>)
+                            {
+                                job(index);
+                            }
+                            else
+                            {
+                                job();
+                            }
+                        };
+                    }
+
+                    void run()
+                    {
+                        m_invoke(m_storage, m_index);
+                        m_waitGroup->done();
+                    }
+
+                private:
+                    alignas(std::max_align_t) unsigned char m_storage[STORAGE_SIZE];
+
+                    void (*m_invoke)(const void *storage, size_t index) = nullptr;
+
+                    WaitGroup *m_waitGroup = nullptr;
+
+                    size_t m_index = 0;
+            };
+
+            /* A growable ring buffer of tasks. The owning thread works from
+             * the back, thieves take from the front. */
+            struct Worker
+            {
+                std::mutex mutex;
+
+                std::vector<Task> tasks = std::vector<Task>(64);
+
+                size_t head = 0;
+
+                size_t count = 0;
+
+                std::thread thread;
+            };
+
+            static constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+
+            //////////////////////////////
+            /* PRIVATE MEMBER FUNCTIONS */
+            //////////////////////////////
+
+            /* The index of the calling thread in this pool, if it belongs to it */
+            size_t currentWorkerIndex() const
+            {
+                return t_pool == this ? t_workerIndex : NOT_A_WORKER;
+            }
+
+            void push(const Task &task)
+            {
+                size_t index = currentWorkerIndex();
+
+                if (index == NOT_A_WORKER)
+                {
+                    index = m_nextWorker++ % m_workers.size();
+                }
+
+                Worker &worker = *m_workers[index];
+
+                {
+                    std::scoped_lock<std::mutex> lock(worker.mutex);
+
+                    if (worker.count == worker.tasks.size())
+                    {
+                        /* Unroll the ring into a buffer twice the size */
+                        std::vector<Task> tasks(worker.tasks.size() * 2);
+
+                        for (size_t i = 0; i < worker.count; i++)
+                        {
+                            tasks[i] = worker.tasks[(worker.head + i) % worker.tasks.size()];
+                        }
+
+                        worker.tasks.swap(tasks);
+                        worker.head = 0;
+                    }
+
+                    worker.tasks[(worker.head + worker.count) % worker.tasks.size()] = task;
+                    worker.count++;
+
+                    m_queuedTasks++;
+                }
+            }
+
+            bool popBack(Worker &worker, Task &task)
+            {
+                std::scoped_lock<std::mutex> lock(worker.mutex);
+
+                if (worker.count == 0)
+                {
+                    return false;
+                }
+
+                worker.count--;
+                task = worker.tasks[(worker.head + worker.count) % worker.tasks.size()];
+
+                m_queuedTasks--;
+
+                return true;
+            }
+
+            bool popFront(Worker &worker, Task &task)
+            {
+                std::scoped_lock<std::mutex> lock(worker.mutex);
+
+                if (worker.count == 0)
+                {
+                    return false;
+                }
+
+                task = worker.tasks[worker.head];
+                worker.head = (worker.head + 1) % worker.tasks.size();
+                worker.count--;
+
+                m_queuedTasks--;
+
+                return true;
+            }
+
+            /* Takes a task from our own deque, or steals one from another */
+            bool takeTask(const size_t workerIndex, Task &task)
+            {
+                if (m_queuedTasks == 0)
+                {
+                    return false;
+                }
+
+                bool found = workerIndex != NOT_A_WORKER && popBack(*m_workers[workerIndex], task);
+
+                /* Start with our neighbour, so thieves spread out */
+                const size_t start = workerIndex == NOT_A_WORKER ? 0 : workerIndex + 1;
+
+                for (size_t i = 0; !found && i < m_workers.size(); i++)
+                {
+                    const size_t victim = (start + i) % m_workers.size();
+
+                    if (victim != workerIndex)
+                    {
+                        found = popFront(*m_workers[victim], task);
+                    }
+                }
+
+                return found;
+            }
+
+            void wakeThreads(const bool all)
+            {
+                /* Taking the lock ensures a thread about to sleep has either
+                 * seen the new task, or is already waiting to be notified */
+                if (m_sleepingThreads > 0)
+                {
+                    std::scoped_lock<std::mutex> lock(m_sleepMutex);
+
+                    if (all)
+                    {
+                        m_haveJob.notify_all();
+                    }
+                    else
+                    {
+                        m_haveJob.notify_one();
+                    }
+                }
+            }
+
+            void workerLoop(const size_t workerIndex)
+            {
+                t_pool = this;
+                t_workerIndex = workerIndex;
+
+                Task task;
+
+                while (true)
+                {
+                    if (takeTask(workerIndex, task))
+                    {
+                        task.run();
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(m_sleepMutex);
+
+                    m_sleepingThreads++;
+
+                    m_haveJob.wait(lock, [this] {
+                        return m_shouldStop || m_queuedTasks > 0;
+                    });
+
+                    m_sleepingThreads--;
+
+                    if (m_shouldStop && m_queuedTasks == 0)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            //////////////////////////////
+            /* PRIVATE MEMBER VARIABLES */
+            //////////////////////////////
+
+            /* The thread and deque of each worker */
+            std::vector<std::unique_ptr<Worker>> m_workers;
+
+            /* Round robins jobs submitted from outside the pool */
+            std::atomic<size_t> m_nextWorker = 0;
+
+            /* Tasks sitting in any of the deques */
+            std::atomic<size_t> m_queuedTasks = 0;
+
+            std::atomic<size_t> m_sleepingThreads = 0;
+
+            /* Whether we're stopping */
+            bool m_shouldStop = false;
+
+            /* Guards threads going to sleep, and m_shouldStop */
+            std::mutex m_sleepMutex;
+
+            /* Whether we have a new job to process */
+            std::condition_variable m_haveJob;
+
+            /* The pool the current thread belongs to, if any */
+            inline static thread_local const WorkStealingThreadPool *t_pool = nullptr;
+
+            inline static thread_local size_t t_workerIndex = 0;
+    };
+}
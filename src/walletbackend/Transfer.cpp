@@ -684,7 +684,7 @@ namespace SendTransaction
         return SUCCESS;
     }
 
-    /* Possibly we could abstract some of this from processTransactionOutputs...
+    /* Possibly we could abstract some of this from processBlockOutputs...
        but I think it would make the code harder to follow */
     void storeUnconfirmedIncomingInputs(
         const std::shared_ptr<SubWallets> subWallets,
@@ -692,23 +692,23 @@ namespace SendTransaction
         const Crypto::PublicKey txPublicKey,
         const Crypto::Hash txHash)
     {
-        Crypto::KeyDerivation derivation;
+        const auto derivations = Crypto::generate_key_derivations({txPublicKey}, subWallets->getPrivateViewKey());
 
-        Crypto::generate_key_derivation(txPublicKey, subWallets->getPrivateViewKey(), derivation);
+        std::vector<Crypto::OutputToUnderive> outputs;
 
-        uint64_t outputIndex = 0;
-
-        for (const auto output : keyOutputs)
+        for (size_t outputIndex = 0; outputIndex < keyOutputs.size(); outputIndex++)
         {
-            Crypto::PublicKey spendKey;
+            outputs.push_back({0, outputIndex, keyOutputs[outputIndex].key});
+        }
 
-            /* Not our output */
-            Crypto::underive_public_key(derivation, outputIndex, output.key, spendKey);
+        const auto derivedSpendKeys = Crypto::underive_public_keys(derivations, outputs);
 
-            const auto spendKeys = subWallets->m_publicSpendKeys;
+        const auto spendKeys = subWallets->m_publicSpendKeys;
 
+        for (size_t outputIndex = 0; outputIndex < keyOutputs.size(); outputIndex++)
+        {
             /* See if the derived spend key is one of ours */
-            const auto it = std::find(spendKeys.begin(), spendKeys.end(), spendKey);
+            const auto it = std::find(spendKeys.begin(), spendKeys.end(), derivedSpendKeys[outputIndex]);
 
             if (it != spendKeys.end())
             {
@@ -722,8 +722,6 @@ namespace SendTransaction
 
                 subWallets->storeUnconfirmedIncomingInput(input, ourSpendKey);
             }
-
-            outputIndex++;
         }
     }
 
@@ -298,20 +298,83 @@ void WalletSynchronizer::blockProcessingThread()
 std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>>
     WalletSynchronizer::processBlockOutputs(const WalletTypes::WalletBlockInfo &block) const
 {
-    std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> inputs;
+    /* Gather up every transaction in the block, so we can derive all of
+       the outputs in one batch, rather than one output at a time */
+    std::vector<const WalletTypes::RawCoinbaseTransaction *> transactions;
 
     if (!Config::config.wallet.skipCoinbaseTransactions && block.coinbaseTransaction)
     {
-        const auto newInputs = processTransactionOutputs(*(block.coinbaseTransaction), block.blockHeight);
+        transactions.push_back(&*block.coinbaseTransaction);
+    }
 
-        inputs.insert(inputs.end(), newInputs.begin(), newInputs.end());
+    for (const auto &tx : block.transactions)
+    {
+        transactions.push_back(&tx);
     }
 
-    for (const auto tx : block.transactions)
+    std::vector<Crypto::PublicKey> txPublicKeys;
+
+    std::vector<Crypto::OutputToUnderive> outputs;
+
+    for (size_t i = 0; i < transactions.size(); i++)
     {
-        const auto newInputs = processTransactionOutputs(tx, block.blockHeight);
+        txPublicKeys.push_back(transactions[i]->transactionPublicKey);
 
-        inputs.insert(inputs.end(), newInputs.begin(), newInputs.end());
+        for (size_t outputIndex = 0; outputIndex < transactions[i]->keyOutputs.size(); outputIndex++)
+        {
+            outputs.push_back({i, outputIndex, transactions[i]->keyOutputs[outputIndex].key});
+        }
+    }
+
+    const auto derivations = Crypto::generate_key_derivations(txPublicKeys, m_privateViewKey);
+
+    const auto derivedSpendKeys = Crypto::underive_public_keys(derivations, outputs);
+
+    const std::vector<Crypto::PublicKey> spendKeys = m_subWallets->m_publicSpendKeys;
+
+    std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> inputs;
+
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        const Crypto::PublicKey &derivedSpendKey = derivedSpendKeys[i];
+
+        /* See if the derived spend key matches any of our spend keys */
+        const auto ourSpendKey = std::find(spendKeys.begin(), spendKeys.end(), derivedSpendKey);
+
+        /* If it does, the transaction belongs to us */
+        if (ourSpendKey != spendKeys.end())
+        {
+            const auto &rawTX = *transactions[outputs[i].derivationIndex];
+
+            const uint64_t outputIndex = outputs[i].outputIndex;
+
+            const auto &output = rawTX.keyOutputs[outputIndex];
+
+            /* We need to fill in the key image of the transaction input -
+               we'll let the subwallet do this since we need the private spend
+               key. We use the key images to detect outgoing transactions,
+               and we use the transaction inputs to make transactions ourself */
+            const auto [keyImage, privateEphemeral] = m_subWallets->getTxInputKeyImage(
+                derivedSpendKey, derivations[outputs[i].derivationIndex], outputIndex);
+
+            const uint64_t spendHeight = 0;
+
+            const WalletTypes::TransactionInput input({
+                keyImage,
+                output.amount,
+                block.blockHeight,
+                rawTX.transactionPublicKey,
+                outputIndex,
+                output.globalOutputIndex,
+                output.key,
+                spendHeight,
+                rawTX.unlockTime,
+                rawTX.hash,
+                privateEphemeral
+            });
+
+            inputs.emplace_back(derivedSpendKey, input);
+        }
     }
 
     return inputs;
@@ -530,64 +593,6 @@ std::tuple<std::optional<WalletTypes::Transaction>, std::vector<std::tuple<Crypt
     return {std::nullopt, {}};
 }
 
-std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> WalletSynchronizer::processTransactionOutputs(
-    const WalletTypes::RawCoinbaseTransaction &rawTX,
-    const uint64_t blockHeight) const
-{
-    std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> inputs;
-
-    Crypto::KeyDerivation derivation;
-
-    Crypto::generate_key_derivation(rawTX.transactionPublicKey, m_privateViewKey, derivation);
-
-    const std::vector<Crypto::PublicKey> spendKeys = m_subWallets->m_publicSpendKeys;
-
-    uint64_t outputIndex = 0;
-
-    for (const auto output : rawTX.keyOutputs)
-    {
-        Crypto::PublicKey derivedSpendKey;
-
-        Crypto::underive_public_key(derivation, outputIndex, output.key, derivedSpendKey);
-
-        /* See if the derived spend key matches any of our spend keys */
-        const auto ourSpendKey = std::find(spendKeys.begin(), spendKeys.end(), derivedSpendKey);
-
-        /* If it does, the transaction belongs to us */
-        if (ourSpendKey != spendKeys.end())
-        {
-            /* We need to fill in the key image of the transaction input -
-               we'll let the subwallet do this since we need the private spend
-               key. We use the key images to detect outgoing transactions,
-               and we use the transaction inputs to make transactions ourself */
-            const auto [keyImage, privateEphemeral]
-                = m_subWallets->getTxInputKeyImage(derivedSpendKey, derivation, outputIndex);
-
-            const uint64_t spendHeight = 0;
-
-            const WalletTypes::TransactionInput input({
-                keyImage,
-                output.amount,
-                blockHeight,
-                rawTX.transactionPublicKey,
-                outputIndex,
-                output.globalOutputIndex,
-                output.key,
-                spendHeight,
-                rawTX.unlockTime,
-                rawTX.hash,
-                privateEphemeral
-            });
-
-            inputs.emplace_back(derivedSpendKey, input);
-        }
-
-        outputIndex++;
-    }
-
-    return inputs;
-}
-
 /* When we get the global indexes, we pass in a range of blocks, to obscure
    which transactions we are interested in - the ones that belong to us.
    To do this, we get the global indexes for all transactions in a range.
@@ -138,9 +138,6 @@ class WalletSynchronizer
             const std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> &inputs,
             const WalletTypes::RawTransaction &tx) const;
 
-    std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>>
-        processTransactionOutputs(const WalletTypes::RawCoinbaseTransaction &rawTX, const uint64_t blockHeight) const;
-
     std::unordered_map<Crypto::Hash, std::vector<uint64_t>> getGlobalIndexes(const uint64_t blockHeight) const;
 
     void removeForkedTransactions(const uint64_t forkHeight);